@@ -13,16 +13,18 @@ public class ElementusInventory : ModuleRules
 
 		PublicDependencyModuleNames.AddRange(new[]
 		{
-			"Core"
+			"Core",
+			"NetCore"
 		});
 
 		PrivateDependencyModuleNames.AddRange(new[]
 		{
 			"Engine",
-			"NetCore",
 			"CoreUObject",
 			"GameplayTags",
-			"DeveloperSettings"
+			"DeveloperSettings",
+			"Json",
+			"Projects"
 		});
 	}
 }
\ No newline at end of file
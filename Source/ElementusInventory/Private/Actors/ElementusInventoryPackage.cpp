@@ -8,8 +8,11 @@
 #include "Management/ElementusInventoryFunctions.h"
 #include "Management/ElementusInventoryData.h"
 #include "LogElementusInventory.h"
+#include <GameFramework/PlayerController.h>
+#include <Engine/World.h>
 #include <Net/UnrealNetwork.h>
 #include <Net/Core/PushModel/PushModel.h>
+#include <Net/Subsystems/NetworkSubsystem.h>
 
 #ifdef UE_INLINE_GENERATED_CPP_BY_NAME
 #include UE_INLINE_GENERATED_CPP_BY_NAME(ElementusInventoryPackage)
@@ -21,6 +24,9 @@ AElementusInventoryPackage::AElementusInventoryPackage(const FObjectInitializer&
 	bNetLoadOnClient = false;
 	bReplicates = true;
 
+	// Required to replicate the package inventory only to the viewers through a net condition group
+	bReplicateUsingRegisteredSubObjectList = true;
+
 	PrimaryActorTick.bCanEverTick = false;
 	PrimaryActorTick.bStartWithTickEnabled = false;
 
@@ -41,12 +47,39 @@ void AElementusInventoryPackage::BeginPlay()
 
 	SetDestroyOnEmpty(bDestroyWhenInventoryIsEmpty);
 
-	if (bDestroyWhenInventoryIsEmpty && UElementusInventoryFunctions::HasEmptyParam(PackageInventory->GetItemsArray()))
+	// Nobody owns a package, so its items are replicated to the players that opened it instead of the owner
+	if (HasAuthority() && PackageInventory->GetReplicateItemsToOwnerOnly())
+	{
+		if (UNetworkSubsystem* const NetworkSubsystem = GetWorld()->GetSubsystem<UNetworkSubsystem>())
+		{
+			ViewerGroup = FName(*FString::Printf(TEXT("ElementusPackage.%s"), *GetPathName()));
+
+			NetworkSubsystem->GetNetConditionGroupManager().RegisterSubObjectInGroup(PackageInventory, ViewerGroup);
+			SetReplicatedComponentNetCondition(PackageInventory, COND_NetGroup);
+		}
+	}
+
+	if (bDestroyWhenInventoryIsEmpty && PackageInventory->GetItemsView().Num() == 0)
 	{
 		Destroy();
 	}
 }
 
+void AElementusInventoryPackage::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ClosePackage();
+
+	if (!ViewerGroup.IsNone())
+	{
+		if (UNetworkSubsystem* const NetworkSubsystem = GetWorld()->GetSubsystem<UNetworkSubsystem>())
+		{
+			NetworkSubsystem->GetNetConditionGroupManager().UnregisterSubObjectFromGroup(PackageInventory, ViewerGroup);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AElementusInventoryPackage::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
@@ -69,6 +102,85 @@ void AElementusInventoryPackage::GetItemFromPackage(const TArray<FElementusItemI
 	MARK_PROPERTY_DIRTY_FROM_NAME(AElementusInventoryPackage, PackageInventory, this);
 }
 
+/* Player controller of the given actor: the actor itself, or the first player controller in its owner chain, like the controller of a pawn */
+static APlayerController* GetViewerController(AActor* InActor)
+{
+	for (AActor* Iterator = InActor; IsValid(Iterator); Iterator = Iterator->GetOwner())
+	{
+		if (APlayerController* const Controller = Cast<APlayerController>(Iterator))
+		{
+			return Controller;
+		}
+	}
+
+	return nullptr;
+}
+
+void AElementusInventoryPackage::OpenPackage(AActor* Opener)
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	APlayerController* const Viewer = GetViewerController(Opener);
+	if (!IsValid(Viewer))
+	{
+		UE_LOG(LogElementusInventory_Internal, Warning, TEXT("ElementusInventory - %s: Actor %s isn't controlled by a player"), *FString(__FUNCTION__),
+		       *GetNameSafe(Opener));
+
+		return;
+	}
+
+	if (Viewers.Contains(Viewer))
+	{
+		return;
+	}
+
+	Viewers.Add(Viewer);
+
+	if (!ViewerGroup.IsNone())
+	{
+		Viewer->IncludeInNetConditionGroup(ViewerGroup);
+		ForceNetUpdate();
+	}
+}
+
+void AElementusInventoryPackage::ClosePackage(AActor* Closer)
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	if (IsValid(Closer))
+	{
+		RemoveViewer(GetViewerController(Closer));
+		return;
+	}
+
+	for (const TWeakObjectPtr<APlayerController>& Iterator : TArray<TWeakObjectPtr<APlayerController>>(Viewers))
+	{
+		RemoveViewer(Iterator.Get());
+	}
+
+	Viewers.Reset();
+}
+
+void AElementusInventoryPackage::RemoveViewer(APlayerController* const Viewer)
+{
+	if (!IsValid(Viewer) || Viewers.Remove(Viewer) == 0)
+	{
+		return;
+	}
+
+	if (!ViewerGroup.IsNone())
+	{
+		Viewer->RemoveFromNetConditionGroup(ViewerGroup);
+		ForceNetUpdate();
+	}
+}
+
 void AElementusInventoryPackage::SetDestroyOnEmpty(const bool bDestroy)
 {
 	if (bDestroyWhenInventoryIsEmpty == bDestroy)
@@ -5,10 +5,18 @@
 #include "Components/ElementusInventoryComponent.h"
 #include "Management/ElementusInventoryFunctions.h"
 #include "Management/ElementusInventorySettings.h"
+#include "Management/ElementusInventoryCache.h"
+#include "Management/ElementusInventorySubsystem.h"
+#include "Components/ElementusInventorySnapshot.h"
 #include "LogElementusInventory.h"
+#include "ElementusInventoryStats.h"
 #include <Engine/AssetManager.h>
 #include <GameFramework/Actor.h>
-#include <Algo/ForEach.h>
+#include <Engine/World.h>
+#include <TimerManager.h>
+#include <Algo/BinarySearch.h>
+#include <Algo/StableSort.h>
+#include <Misc/StringBuilder.h>
 #include <Net/UnrealNetwork.h>
 #include <Net/Core/PushModel/PushModel.h>
 
@@ -17,7 +25,7 @@
 #endif
 
 UElementusInventoryComponent::UElementusInventoryComponent(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer),
-	CurrentWeight(0.f), MaxWeight(0.f), MaxNumItems(0)
+	CurrentWeight(0.f), CurrentValue(0.f), MaxWeight(0.f), MaxNumItems(0)
 {
 	PrimaryComponentTick.bCanEverTick = false;
 	PrimaryComponentTick.bStartWithTickEnabled = false;
@@ -27,6 +35,9 @@ UElementusInventoryComponent::UElementusInventoryComponent(const FObjectInitiali
 	if (const UElementusInventorySettings* const Settings = UElementusInventorySettings::Get())
 	{
 		bAllowEmptySlots = Settings->bAllowEmptySlots;
+		bEnableItemIndexing = Settings->bEnableItemIndexing;
+		bCompactItemRuns = Settings->bCompactItemRuns;
+		bReplicateItemsToOwnerOnly = Settings->bReplicateItemsToOwnerOnly;
 		MaxWeight = Settings->MaxWeight;
 		MaxNumItems = Settings->MaxNumItems;
 	}
@@ -37,6 +48,11 @@ float UElementusInventoryComponent::GetCurrentWeight() const
 	return CurrentWeight;
 }
 
+float UElementusInventoryComponent::GetCurrentValue() const
+{
+	return CurrentValue;
+}
+
 float UElementusInventoryComponent::GetMaxWeight() const
 {
 	return MaxWeight <= 0.f ? MAX_flt : MaxWeight;
@@ -44,7 +60,21 @@ float UElementusInventoryComponent::GetMaxWeight() const
 
 int32 UElementusInventoryComponent::GetCurrentNumItems() const
 {
-	return ElementusItems.Num();
+	if (!HasFixedSlots())
+	{
+		return ItemSlots.Num();
+	}
+
+	int32 Output = 0;
+	for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
+	{
+		if (UElementusInventoryFunctions::IsItemValid(Iterator.ItemInfo))
+		{
+			Output += Iterator.RunLength;
+		}
+	}
+
+	return Output;
 }
 
 int32 UElementusInventoryComponent::GetMaxNumItems() const
@@ -52,19 +82,107 @@ int32 UElementusInventoryComponent::GetMaxNumItems() const
 	return MaxNumItems <= 0 ? MAX_int32 : MaxNumItems;
 }
 
+int32 UElementusInventoryComponent::GetNumAvailableSlots() const
+{
+	if (GetMaxNumItems() == MAX_int32)
+	{
+		return MAX_int32;
+	}
+
+	int32 Output = FMath::Max(GetMaxNumItems() - ItemSlots.Num(), 0);
+
+	if (bAllowEmptySlots)
+	{
+		for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
+		{
+			if (!UElementusInventoryFunctions::IsItemValid(Iterator.ItemInfo))
+			{
+				Output += Iterator.RunLength;
+			}
+		}
+	}
+
+	return Output;
+}
+
 TArray<FElementusItemInfo> UElementusInventoryComponent::GetItemsArray() const
 {
-	return ElementusItems;
+	return ItemSlots.ToArray();
+}
+
+FElementusInventorySummary UElementusInventoryComponent::GetInventorySummary() const
+{
+	return InventorySummary;
+}
+
+bool UElementusInventoryComponent::GetReplicateItemsToOwnerOnly() const
+{
+	return bReplicateItemsToOwnerOnly;
+}
+
+void UElementusInventoryComponent::SetReplicateItemsToOwnerOnly(const bool bOwnerOnly)
+{
+	if (bReplicateItemsToOwnerOnly == bOwnerOnly)
+	{
+		return;
+	}
+
+	bReplicateItemsToOwnerOnly = bOwnerOnly;
+
+	if (GetOwnerRole() == ROLE_Authority && HasBegunPlay())
+	{
+		UpdateReplicationConditions();
+		UpdateInventorySummary();
+	}
 }
 
 FElementusItemInfo& UElementusInventoryComponent::GetItemReferenceAt(const int32 Index)
 {
-	return ElementusItems[Index];
+	// The caller may change the item id through the returned reference, without notifying the index
+	SaveSlotsForRollback(Index);
+	ItemIndex.MarkDirty();
+	MarkSlotsDirty();
+
+	return ItemSlots.GetMutable(Index);
+}
+
+bool UElementusInventoryComponent::SetItemAt(const int32 Index, const FElementusItemInfo& InItemInfo)
+{
+	if (GetOwnerRole() != ROLE_Authority || !ItemSlots.IsValidIndex(Index))
+	{
+		return false;
+	}
+
+	const FElementusItemInfo& ExistingItem = ItemSlots[Index];
+	if (FElementusItemRun::HasSameContent(ExistingItem, InItemInfo))
+	{
+		return true;
+	}
+
+	SaveSlotsForRollback(Index);
+
+	if (UElementusInventoryFunctions::IsItemValid(ExistingItem))
+	{
+		ApplyItemWeightDelta(ExistingItem.ItemId, -ExistingItem.Quantity);
+	}
+
+	if (UElementusInventoryFunctions::IsItemValid(InItemInfo))
+	{
+		ApplyItemWeightDelta(InItemInfo.ItemId, InItemInfo.Quantity);
+	}
+
+	// Written through the runs, so the index follows the change instead of being rebuilt
+	ItemSlots.Set(Index, InItemInfo);
+	MarkSlotsDirty();
+
+	NotifyInventoryChange();
+
+	return true;
 }
 
 FElementusItemInfo UElementusInventoryComponent::GetItemCopyAt(const int32 Index) const
 {
-	return ElementusItems[Index];
+	return ItemSlots[Index];
 }
 
 bool UElementusInventoryComponent::CanReceiveItem(const FElementusItemInfo InItemInfo) const
@@ -74,11 +192,11 @@ bool UElementusInventoryComponent::CanReceiveItem(const FElementusItemInfo InIte
 		return false;
 	}
 
-	bool bOutput = ElementusItems.Num() <= GetMaxNumItems();
+	bool bOutput = ItemSlots.Num() <= GetMaxNumItems();
 
-	if (const UElementusItemData* const ItemData = UElementusInventoryFunctions::GetSingleItemDataById(InItemInfo.ItemId, {"Data"}))
+	if (FElementusItemDefinition ItemDefinition; FElementusItemDefinitionCache::Get().FindDefinition(InItemInfo.ItemId, ItemDefinition))
 	{
-		bOutput = bOutput && ((GetCurrentWeight() + (ItemData->ItemWeight * InItemInfo.Quantity)) <= GetMaxWeight());
+		bOutput = bOutput && ((GetCurrentWeight() + (ItemDefinition.ItemWeight * InItemInfo.Quantity)) <= GetMaxWeight());
 	}
 
 	if (!bOutput)
@@ -97,14 +215,8 @@ bool UElementusInventoryComponent::CanGiveItem(const FElementusItemInfo InItemIn
 		return false;
 	}
 
-	if (TArray<int32> InIndex; FindAllItemIndexesWithInfo(InItemInfo, InIndex, FGameplayTagContainer::EmptyContainer))
+	if (const int32 Quantity = GetItemQuantity(InItemInfo); Quantity > 0)
 	{
-		int32 Quantity = 0u;
-		for (const int32& Index : InIndex)
-		{
-			Quantity += ElementusItems[Index].Quantity;
-		}
-
 		return Quantity >= InItemInfo.Quantity;
 	}
 
@@ -114,724 +226,1958 @@ bool UElementusInventoryComponent::CanGiveItem(const FElementusItemInfo InItemIn
 	return false;
 }
 
-void UElementusInventoryComponent::SortInventory(const EElementusInventorySortingMode Mode, const EElementusInventorySortingOrientation Orientation)
+int32 UElementusInventoryComponent::GetItemQuantity(const FElementusItemInfo& InItemInfo) const
 {
-	const auto SortByOrientation = [Orientation](const auto A, const auto B)
+	ELEMENTUS_INVENTORY_SCOPE(FindItems);
+
+	if (const FElementusInventoryIndex* const Index = GetItemIndex())
 	{
-		switch (Orientation)
+		return Index->GetQuantity(InItemInfo);
+	}
+
+	int32 Output = 0;
+	for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
+	{
+		if (Iterator.ItemInfo == InItemInfo)
 		{
-		case EElementusInventorySortingOrientation::Ascending:
-			return A < B;
+			Output += Iterator.ItemInfo.Quantity * Iterator.RunLength;
+		}
+	}
 
-		case EElementusInventorySortingOrientation::Descending:
-			return A > B;
+	return Output;
+}
 
-		default:
-			return false;
-		}
-	};
+int32 UElementusInventoryComponent::GetItemQuantityWithId(const FPrimaryElementusItemId& InId) const
+{
+	ELEMENTUS_INVENTORY_SCOPE(FindItems);
 
-	switch (Mode)
+	if (const FElementusInventoryIndex* const Index = GetItemIndex())
 	{
-	case EElementusInventorySortingMode::ID:
-		ElementusItems.Sort([SortByOrientation](const FElementusItemInfo& A, const FElementusItemInfo& B)
-		{
-			return UElementusInventoryFunctions::IsItemValid(A) && SortByOrientation(A.ItemId, B.ItemId);
-		});
-		break;
+		return Index->GetQuantityWithId(InId);
+	}
 
-	case EElementusInventorySortingMode::Name:
-		ElementusItems.Sort([SortByOrientation](const FElementusItemInfo& A, const FElementusItemInfo& B)
+	int32 Output = 0;
+	for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
+	{
+		if (Iterator.ItemInfo.ItemId == InId)
 		{
-			if (!UElementusInventoryFunctions::IsItemValid(A))
-			{
-				return false;
-			}
+			Output += Iterator.ItemInfo.Quantity * Iterator.RunLength;
+		}
+	}
 
-			if (const UElementusItemData* const ItemDataA = UElementusInventoryFunctions::GetSingleItemDataById(A.ItemId, {"Data"}))
-			{
-				if (const UElementusItemData* const ItemDataB = UElementusInventoryFunctions::GetSingleItemDataById(B.ItemId, {"Data"}))
-				{
-					return SortByOrientation(ItemDataA->ItemName.ToString(), ItemDataB->ItemName.ToString());
-				}
-			}
+	return Output;
+}
 
-			return false;
-		});
-		break;
+bool UElementusInventoryComponent::HasAllItems(const TArray<FElementusItemInfo>& Requirements) const
+{
+	ELEMENTUS_INVENTORY_SCOPE(FindItems);
 
-	case EElementusInventorySortingMode::Type:
-		ElementusItems.Sort([SortByOrientation](const FElementusItemInfo& A, const FElementusItemInfo& B)
+	// The same item may be required more than once, so the quantities are summed before checking
+	TMap<FElementusItemStackKey, int32> RequiredQuantities;
+	RequiredQuantities.Reserve(Requirements.Num());
+
+	for (const FElementusItemInfo& Iterator : Requirements)
+	{
+		if (Iterator.Quantity > 0)
 		{
-			if (!UElementusInventoryFunctions::IsItemValid(A))
-			{
-				return false;
-			}
+			RequiredQuantities.FindOrAdd(FElementusItemStackKey(Iterator)) += Iterator.Quantity;
+		}
+	}
 
-			if (const UElementusItemData* const ItemDataA = UElementusInventoryFunctions::GetSingleItemDataById(A.ItemId, {"Data"}))
-			{
-				if (const UElementusItemData* const ItemDataB = UElementusInventoryFunctions::GetSingleItemDataById(B.ItemId, {"Data"}))
-				{
-					return SortByOrientation(ItemDataA->ItemType, ItemDataB->ItemType);
-				}
-			}
+	for (const TPair<FElementusItemStackKey, int32>& Iterator : RequiredQuantities)
+	{
+		FElementusItemInfo RequiredItem(FPrimaryElementusItemId(Iterator.Key.ItemId), Iterator.Value, Iterator.Key.Tags);
+		RequiredItem.Level = Iterator.Key.Level;
 
+		if (GetItemQuantity(RequiredItem) < Iterator.Value)
+		{
 			return false;
-		});
-		break;
+		}
+	}
 
-	case EElementusInventorySortingMode::IndividualValue:
-		ElementusItems.Sort([SortByOrientation](const FElementusItemInfo& A, const FElementusItemInfo& B)
-		{
-			if (!UElementusInventoryFunctions::IsItemValid(A))
-			{
-				return false;
-			}
+	return true;
+}
 
-			if (const UElementusItemData* const ItemDataA = UElementusInventoryFunctions::GetSingleItemDataById(A.ItemId, {"Data"}))
-			{
-				if (const UElementusItemData* const ItemDataB = UElementusInventoryFunctions::GetSingleItemDataById(B.ItemId, {"Data"}))
-				{
-					return SortByOrientation(ItemDataA->ItemValue, ItemDataB->ItemValue);
-				}
-			}
+/* Values of an item used by the sorting modes, extracted once per item before sorting */
+struct FElementusItemSortKey
+{
+	/* Run of the item in the inventory slots */
+	int32 SourceIndex = INDEX_NONE;
+	bool bIsValid = false;
+	FPrimaryElementusItemId ItemId;
+	FName ItemName = NAME_None;
+	EElementusItemType ItemType = EElementusItemType::None;
+	float ItemValue = 0.f;
+	float ItemWeight = 0.f;
+	int32 Quantity = 0;
+	int32 Level = 0;
+	int32 NumTags = 0;
+};
+
+template <typename Ty>
+static int32 CompareSortValues(const Ty& A, const Ty& B)
+{
+	return A < B ? -1 : (B < A ? 1 : 0);
+}
 
-			return false;
-		});
-		break;
+/* Compare the name strings, where FName::Compare would order numbered names like "Item_2" and "Item_10" by their number */
+static int32 CompareNameStrings(const FName& A, const FName& B)
+{
+	if (A == B)
+	{
+		return 0;
+	}
 
-	case EElementusInventorySortingMode::StackValue:
-		ElementusItems.Sort([SortByOrientation](const FElementusItemInfo& A, const FElementusItemInfo& B)
-		{
-			if (!UElementusInventoryFunctions::IsItemValid(A))
-			{
-				return false;
-			}
+	TStringBuilder<128> AString;
+	A.AppendString(AString);
 
-			if (const UElementusItemData* const ItemDataA = UElementusInventoryFunctions::GetSingleItemDataById(A.ItemId, {"Data"}))
-			{
-				if (const UElementusItemData* const ItemDataB = UElementusInventoryFunctions::GetSingleItemDataById(B.ItemId, {"Data"}))
-				{
-					return SortByOrientation(ItemDataA->ItemValue * A.Quantity, ItemDataB->ItemValue * B.Quantity);
-				}
-			}
+	TStringBuilder<128> BString;
+	B.AppendString(BString);
 
-			return false;
-		});
-		break;
+	return FCString::Stricmp(*AString, *BString);
+}
 
-	case EElementusInventorySortingMode::IndividualWeight:
-		ElementusItems.Sort([SortByOrientation](const FElementusItemInfo& A, const FElementusItemInfo& B)
-		{
-			if (!UElementusInventoryFunctions::IsItemValid(A))
-			{
-				return false;
-			}
+static int32 CompareSortKeys(const FElementusItemSortKey& A, const FElementusItemSortKey& B, const EElementusInventorySortingMode Mode)
+{
+	switch (Mode)
+	{
+	case EElementusInventorySortingMode::ID:
+		return CompareSortValues(A.ItemId, B.ItemId);
 
-			if (const UElementusItemData* const ItemDataA = UElementusInventoryFunctions::GetSingleItemDataById(A.ItemId, {"Data"}))
-			{
-				if (const UElementusItemData* const ItemDataB = UElementusInventoryFunctions::GetSingleItemDataById(B.ItemId, {"Data"}))
-				{
-					return SortByOrientation(ItemDataA->ItemWeight, ItemDataB->ItemWeight);
-				}
-			}
+	case EElementusInventorySortingMode::Name:
+		return CompareNameStrings(A.ItemName, B.ItemName);
 
-			return false;
-		});
-		break;
+	case EElementusInventorySortingMode::Type:
+		return CompareSortValues(A.ItemType, B.ItemType);
 
-	case EElementusInventorySortingMode::StackWeight:
-		ElementusItems.Sort([SortByOrientation](const FElementusItemInfo& A, const FElementusItemInfo& B)
-		{
-			if (!UElementusInventoryFunctions::IsItemValid(A))
-			{
-				return false;
-			}
+	case EElementusInventorySortingMode::IndividualValue:
+		return CompareSortValues(A.ItemValue, B.ItemValue);
 
-			if (const UElementusItemData* const ItemDataA = UElementusInventoryFunctions::GetSingleItemDataById(A.ItemId, {"Data"}))
-			{
-				if (const UElementusItemData* const ItemDataB = UElementusInventoryFunctions::GetSingleItemDataById(B.ItemId, {"Data"}))
-				{
-					return SortByOrientation(ItemDataA->ItemWeight * A.Quantity, ItemDataB->ItemWeight * B.Quantity);
-				}
-			}
+	case EElementusInventorySortingMode::StackValue:
+		return CompareSortValues(A.ItemValue * A.Quantity, B.ItemValue * B.Quantity);
 
-			return false;
-		});
-		break;
+	case EElementusInventorySortingMode::IndividualWeight:
+		return CompareSortValues(A.ItemWeight, B.ItemWeight);
+
+	case EElementusInventorySortingMode::StackWeight:
+		return CompareSortValues(A.ItemWeight * A.Quantity, B.ItemWeight * B.Quantity);
 
 	case EElementusInventorySortingMode::Quantity:
-		ElementusItems.Sort([SortByOrientation](const FElementusItemInfo& A, const FElementusItemInfo& B)
-		{
-			return UElementusInventoryFunctions::IsItemValid(A) && SortByOrientation(A.Quantity, B.Quantity);
-		});
-		break;
+		return CompareSortValues(A.Quantity, B.Quantity);
 
 	case EElementusInventorySortingMode::Level:
-		ElementusItems.Sort([SortByOrientation](const FElementusItemInfo& A, const FElementusItemInfo& B)
-		{
-			return UElementusInventoryFunctions::IsItemValid(A) && SortByOrientation(A.Level, B.Level);
-		});
-		break;
+		return CompareSortValues(A.Level, B.Level);
 
 	case EElementusInventorySortingMode::Tags:
-		ElementusItems.Sort([SortByOrientation](const FElementusItemInfo& A, const FElementusItemInfo& B)
-		{
-			return UElementusInventoryFunctions::IsItemValid(A) && SortByOrientation(A.Tags.Num(), B.Tags.Num());
-		});
-		break;
+		return CompareSortValues(A.NumTags, B.NumTags);
 
 	default:
 		break;
 	}
-}
-
-void UElementusInventoryComponent::BeginPlay()
-{
-	Super::BeginPlay();
 
-	RefreshInventory();
+	return 0;
 }
 
-void UElementusInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+void UElementusInventoryComponent::SortInventory(const EElementusInventorySortingMode Mode, const EElementusInventorySortingOrientation Orientation)
 {
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-
-	FDoRepLifetimeParams SharedParams;
-	SharedParams.bIsPushBased = true;
+	FElementusInventorySortingKey SortingKey;
+	SortingKey.Mode = Mode;
+	SortingKey.Orientation = Orientation;
 
-	DOREPLIFETIME_WITH_PARAMS_FAST(UElementusInventoryComponent, ElementusItems, SharedParams);
+	SortInventoryByKeys({SortingKey});
 }
 
-void UElementusInventoryComponent::RefreshInventory()
+void UElementusInventoryComponent::SortInventoryByKeys(const TArray<FElementusInventorySortingKey>& SortingKeys)
 {
-	ForceWeightUpdate();
-	ForceInventoryValidation();
-}
+	ELEMENTUS_INVENTORY_SCOPE(Sort);
 
-void UElementusInventoryComponent::ForceWeightUpdate()
-{
-	float NewWeigth = 0.f;
-	for (const FElementusItemInfo& Iterator : ElementusItems)
+	if (UElementusInventoryFunctions::HasEmptyParam(SortingKeys) || ItemSlots.GetRuns().Num() < 2)
+	{
+		return;
+	}
+
+	const bool bRequiresDefinitions = SortingKeys.ContainsByPredicate([](const FElementusInventorySortingKey& Iterator)
 	{
-		if (const UElementusItemData* const ItemData = UElementusInventoryFunctions::GetSingleItemDataById(Iterator.ItemId, {"Data"}))
+		switch (Iterator.Mode)
 		{
-			NewWeigth += ItemData->ItemWeight * Iterator.Quantity;
+		case EElementusInventorySortingMode::Name:
+		case EElementusInventorySortingMode::Type:
+		case EElementusInventorySortingMode::IndividualValue:
+		case EElementusInventorySortingMode::StackValue:
+		case EElementusInventorySortingMode::IndividualWeight:
+		case EElementusInventorySortingMode::StackWeight:
+			return true;
+
+		default:
+			return false;
 		}
-	}
+	});
 
-	CurrentWeight = NewWeigth;
-}
+	// Resolve each run of identical items only once instead of on every comparison
+	const TArrayView<const FElementusItemRun> Runs = ItemSlots.GetRuns();
 
-void UElementusInventoryComponent::ForceInventoryValidation()
-{
-	TArray<FElementusItemInfo> NewItems;
-	TArray<int32> IndexesToRemove;
+	TArray<FElementusItemSortKey> Keys;
+	Keys.Reserve(Runs.Num());
 
-	for (int32 i = 0; i < ElementusItems.Num(); ++i)
+	for (int32 Iterator = 0; Iterator < Runs.Num(); ++Iterator)
 	{
-		if (ElementusItems[i].Quantity <= 0)
+		const FElementusItemInfo& Item = Runs[Iterator].ItemInfo;
+
+		FElementusItemSortKey& NewKey = Keys.AddDefaulted_GetRef();
+		NewKey.SourceIndex = Iterator;
+		NewKey.bIsValid = UElementusInventoryFunctions::IsItemValid(Item);
+		NewKey.ItemId = Item.ItemId;
+		NewKey.Quantity = Item.Quantity;
+		NewKey.Level = Item.Level;
+		NewKey.NumTags = Item.Tags.Num();
+
+		if (FElementusItemDefinition ItemDefinition; bRequiresDefinitions && NewKey.bIsValid && FElementusItemDefinitionCache::Get().
+			FindDefinition(Item.ItemId, ItemDefinition))
 		{
-			IndexesToRemove.Add(i);
+			NewKey.ItemName = ItemDefinition.ItemName;
+			NewKey.ItemType = ItemDefinition.ItemType;
+			NewKey.ItemValue = ItemDefinition.ItemValue;
+			NewKey.ItemWeight = ItemDefinition.ItemWeight;
 		}
+	}
 
-		else if (ElementusItems[i].Quantity > 1)
+	// Stable sort: items with equal keys and invalid/empty slots, which are always pushed to the end, keep their relative order
+	Algo::StableSort(Keys, [&SortingKeys](const FElementusItemSortKey& A, const FElementusItemSortKey& B)
+	{
+		if (A.bIsValid != B.bIsValid)
 		{
-			if (!UElementusInventoryFunctions::IsItemStackable(ElementusItems[i]))
-			{
-				for (int32 j = 0; j < ElementusItems[i].Quantity; ++j)
-				{
-					NewItems.Add(FElementusItemInfo(ElementusItems[i].ItemId, 1, ElementusItems[i].Tags));
-				}
+			return A.bIsValid;
+		}
 
-				IndexesToRemove.Add(i);
-			}
+		if (!A.bIsValid)
+		{
+			return false;
 		}
-	}
 
-	if (!UElementusInventoryFunctions::HasEmptyParam(IndexesToRemove))
-	{
-		for (const int32& Iterator : IndexesToRemove)
+		for (const FElementusInventorySortingKey& Iterator : SortingKeys)
 		{
-			if (bAllowEmptySlots)
-			{
-				ElementusItems[Iterator] = FElementusItemInfo::EmptyItemInfo;
-			}
-			else
+			if (const int32 Result = CompareSortKeys(A, B, Iterator.Mode); Result != 0)
 			{
-				ElementusItems.RemoveAt(Iterator, 1, false);
+				return Iterator.Orientation == EElementusInventorySortingOrientation::Descending ? Result > 0 : Result < 0;
 			}
 		}
-	}
-	if (!UElementusInventoryFunctions::HasEmptyParam(NewItems))
+
+		return false;
+	});
+
+	SaveSlotsFromForRollback(0);
+
+	// Identical runs that end up next to each other are merged
+	FElementusItemSlots SortedItems;
+	SortedItems.SetCompactRuns(ItemSlots.IsCompactingRuns());
+
+	for (const FElementusItemSortKey& Iterator : Keys)
 	{
-		ElementusItems.Append(NewItems);
+		SortedItems.Add(Runs[Iterator.SourceIndex].ItemInfo, Runs[Iterator.SourceIndex].RunLength);
 	}
 
+	ItemSlots = MoveTemp(SortedItems);
+
+	MarkSlotsDirty();
 	NotifyInventoryChange();
 }
 
-bool UElementusInventoryComponent::FindFirstItemIndexWithInfo(const FElementusItemInfo& InItemInfo, int32& OutIndex,
-                                                              const FGameplayTagContainer& IgnoreTags, const int32 Offset) const
+void UElementusInventoryComponent::BeginInventoryTransaction()
 {
-	for (int32 Iterator = Offset; Iterator < ElementusItems.Num(); ++Iterator)
+	if (GetOwnerRole() != ROLE_Authority)
 	{
-		FElementusItemInfo InParamCopy = InItemInfo;
-		InParamCopy.Tags.RemoveTags(IgnoreTags);
-
-		FElementusItemInfo InExistingCopy = ElementusItems[Iterator];
-		InExistingCopy.Tags.RemoveTags(IgnoreTags);
-
-		if (InExistingCopy == InParamCopy)
-		{
-			OutIndex = Iterator;
-			return true;
-		}
+		return;
 	}
 
-	OutIndex = INDEX_NONE;
-	return false;
+	if (TransactionDepth++ == 0)
+	{
+		// Slots are only copied to the undo log on their first write, the previous allocations are reused
+		TransactionUndoLog.Reset();
+		TransactionLoggedSlots.Init(false, ItemSlots.Num());
+		TransactionNumSlots = ItemSlots.Num();
+		TransactionSnapshotWeight = CurrentWeight;
+		TransactionSnapshotValue = CurrentValue;
+		bHasPendingInventoryChange = false;
+	}
 }
 
-bool UElementusInventoryComponent::FindFirstItemIndexWithTags(const FGameplayTagContainer& WithTags, int32& OutIndex,
-                                                              const FGameplayTagContainer& IgnoreTags, const int32 Offset) const
+void UElementusInventoryComponent::CommitInventoryTransaction()
 {
-	for (int32 Iterator = Offset; Iterator < ElementusItems.Num(); ++Iterator)
+	if (!IsInTransaction() || --TransactionDepth > 0)
 	{
-		FElementusItemInfo InExistingCopy = ElementusItems[Iterator];
-		InExistingCopy.Tags.RemoveTags(IgnoreTags);
+		return;
+	}
 
-		if (InExistingCopy.Tags.HasAllExact(WithTags))
+	TransactionUndoLog.Reset();
+
+	if (bHasPendingInventoryChange)
+	{
+		bHasPendingInventoryChange = false;
+		NotifyInventoryChange();
+	}
+}
+
+void UElementusInventoryComponent::RollbackInventoryTransaction()
+{
+	if (!IsInTransaction())
+	{
+		return;
+	}
+
+	UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Rolling back %s's inventory transaction"), *FString(__FUNCTION__),
+	       *GetOwner()->GetName());
+
+	// Nothing was replicated or broadcasted during the transaction, so restoring the written slots is enough.
+	// Slots removed during the transaction were all saved, and the ones added after the initial slots are dropped
+	ItemSlots.SetNum(TransactionNumSlots);
+
+	for (const FElementusItemRun& Iterator : TransactionUndoLog)
+	{
+		ItemSlots.SetRange(Iterator.FirstSlot, Iterator.RunLength, Iterator.ItemInfo);
+	}
+
+	TransactionUndoLog.Reset();
+
+	CurrentWeight = TransactionSnapshotWeight;
+	CurrentValue = TransactionSnapshotValue;
+
+	MarkSlotsDirty();
+
+	TransactionDepth = 0;
+	bHasPendingInventoryChange = false;
+}
+
+void UElementusInventoryComponent::SaveSlotsForRollback(const int32 FirstSlot, const int32 NumSlots)
+{
+	if (!IsInTransaction())
+	{
+		return;
+	}
+
+	const int32 EndSlot = FMath::Min3(FirstSlot + NumSlots, TransactionNumSlots, ItemSlots.Num());
+
+	for (int32 Slot = FMath::Max(FirstSlot, 0); Slot < EndSlot;)
+	{
+		if (TransactionLoggedSlots[Slot])
+		{
+			++Slot;
+			continue;
+		}
+
+		// The next slots of the same run that weren't logged yet are saved in the same range
+		const FElementusItemRun& Run = ItemSlots.GetRuns()[ItemSlots.FindRunIndex(Slot)];
+		const int32 RunEnd = FMath::Min(EndSlot, Run.FirstSlot + Run.RunLength);
+
+		int32 RangeEnd = Slot + 1;
+		while (RangeEnd < RunEnd && !TransactionLoggedSlots[RangeEnd])
+		{
+			++RangeEnd;
+		}
+
+		FElementusItemRun& SavedRange = TransactionUndoLog.Emplace_GetRef(Run.ItemInfo, RangeEnd - Slot);
+		SavedRange.FirstSlot = Slot;
+
+		TransactionLoggedSlots.SetRange(Slot, RangeEnd - Slot, true);
+		Slot = RangeEnd;
+	}
+}
+
+void UElementusInventoryComponent::SaveSlotsFromForRollback(const int32 FirstSlot)
+{
+	SaveSlotsForRollback(FirstSlot, TransactionNumSlots - FirstSlot);
+}
+
+bool UElementusInventoryComponent::IsInTransaction() const
+{
+	return TransactionDepth > 0;
+}
+
+void UElementusInventoryComponent::SaveInventorySnapshot(TArray<uint8>& OutData, const bool bPortable) const
+{
+	ELEMENTUS_INVENTORY_SCOPE(SnapshotSave);
+
+	OutData.Reset();
+	FElementusInventorySnapshot::Write(OutData, ItemSlots, CurrentWeight, CurrentValue, bPortable);
+}
+
+bool UElementusInventoryComponent::LoadInventorySnapshot(const TArray<uint8>& InData)
+{
+	ELEMENTUS_INVENTORY_SCOPE(SnapshotLoad);
+
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		return false;
+	}
+
+	FElementusInventorySnapshotData Snapshot;
+	if (!FElementusInventorySnapshot::Read(InData, Snapshot))
+	{
+		UE_LOG(LogElementusInventory, Warning, TEXT("%s: Actor %s couldn't load the inventory snapshot"), *FString(__FUNCTION__),
+		       *GetOwner()->GetName());
+		return false;
+	}
+
+	SaveSlotsFromForRollback(0);
+
+	ItemSlots = MoveTemp(Snapshot.Items);
+	ItemSlots.SetCompactRuns(bCompactItemRuns);
+	MarkSlotsDirty();
+	FillFixedSlots();
+
+	if (Snapshot.bIsKnownValid)
+	{
+		// The snapshot was taken from a validated inventory with the same catalog
+		CurrentWeight = Snapshot.Weight;
+		CurrentValue = Snapshot.Value;
+
+		NotifyInventoryChange();
+	}
+	else
+	{
+		RefreshInventory();
+	}
+
+	return true;
+}
+
+void UElementusInventoryComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	ReplicatedItems.Owner = this;
+
+	// The index and the replicated entries follow each change of the runs instead of comparing all runs after them
+	ItemSlots.AddListener(&ItemIndex);
+	ItemSlots.AddListener(&ReplicatedItems.DirtyRuns);
+}
+
+void UElementusInventoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		UpdateReplicationConditions();
+
+		// The initial items come before the ones added until now, merging the identical neighbors
+		FElementusItemSlots InitialSlots;
+		InitialSlots.SetCompactRuns(bCompactItemRuns);
+		InitialSlots.Append(InitialItems);
+		InitialSlots.Append(ItemSlots);
+
+		ItemSlots = MoveTemp(InitialSlots);
+		MarkSlotsDirty();
+
+		if (HasFixedSlots())
+		{
+			// Slots are reused and never shrunk, so the whole capacity is allocated once
+			ItemSlots.Reserve(MaxNumItems);
+			FreeSlots.Reserve(MaxNumItems);
+
+			FillFixedSlots();
+		}
+
+		if (UElementusInventorySubsystem* const Subsystem = UElementusInventorySubsystem::Get(this))
+		{
+			Subsystem->RegisterInventory(this);
+		}
+
+		RefreshInventory();
+	}
+	else
+	{
+		// Clients mirror the runs of the replicated entries as they are, already validated by the authority
+		ForceWeightUpdate();
+	}
+}
+
+void UElementusInventoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UElementusInventorySubsystem* const Subsystem = UElementusInventorySubsystem::Get(this))
+	{
+		Subsystem->UnregisterInventory(this);
+	}
+
+#if STATS
+	ELEMENTUS_INVENTORY_MEMORY_DELTA(ItemsMemory, -ReportedItemsMemory);
+	ELEMENTUS_INVENTORY_MEMORY_DELTA(ReplicatedItemsMemory, -ReportedReplicatedItemsMemory);
+
+	ReportedItemsMemory = 0;
+	ReportedReplicatedItemsMemory = 0;
+#endif
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UElementusInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams SharedParams;
+	SharedParams.bIsPushBased = true;
+
+	// Conditions are registered once per class: each component sets its own through UpdateReplicationConditions
+	SharedParams.Condition = COND_Dynamic;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UElementusInventoryComponent, ReplicatedItems, SharedParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UElementusInventoryComponent, InventorySummary, SharedParams);
+}
+
+void UElementusInventoryComponent::UpdateReplicationConditions()
+{
+	if (bReplicateItemsToOwnerOnly)
+	{
+		DOREPDYNAMICCONDITION_SETCONDITION_FAST(UElementusInventoryComponent, ReplicatedItems, COND_OwnerOnly);
+		DOREPDYNAMICCONDITION_SETCONDITION_FAST(UElementusInventoryComponent, InventorySummary, COND_SkipOwner);
+	}
+	else
+	{
+		DOREPDYNAMICCONDITION_SETCONDITION_FAST(UElementusInventoryComponent, ReplicatedItems, COND_None);
+		DOREPDYNAMICCONDITION_SETCONDITION_FAST(UElementusInventoryComponent, InventorySummary, COND_Never);
+	}
+}
+
+void UElementusInventoryComponent::RefreshInventory()
+{
+	ForceWeightUpdate();
+	ForceInventoryValidation();
+}
+
+void UElementusInventoryComponent::ForceWeightUpdate()
+{
+	float NewWeight = 0.f;
+	float NewValue = 0.f;
+	for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
+	{
+		if (!UElementusInventoryFunctions::IsItemValid(Iterator.ItemInfo))
+		{
+			continue;
+		}
+
+		if (FElementusItemDefinition ItemDefinition; FElementusItemDefinitionCache::Get().FindDefinition(Iterator.ItemInfo.ItemId, ItemDefinition))
+		{
+			NewWeight += ItemDefinition.ItemWeight * Iterator.ItemInfo.Quantity * Iterator.RunLength;
+			NewValue += ItemDefinition.ItemValue * Iterator.ItemInfo.Quantity * Iterator.RunLength;
+		}
+	}
+
+	CurrentWeight = FMath::Clamp(NewWeight, 0.f, MAX_FLT);
+	CurrentValue = FMath::Clamp(NewValue, 0.f, MAX_FLT);
+}
+
+void UElementusInventoryComponent::ApplyItemWeightDelta(const FPrimaryElementusItemId& InItemId, const int32 QuantityDelta)
+{
+	if (QuantityDelta == 0)
+	{
+		return;
+	}
+
+	if (FElementusItemDefinition ItemDefinition; FElementusItemDefinitionCache::Get().FindDefinition(InItemId, ItemDefinition))
+	{
+		CurrentWeight = FMath::Clamp(CurrentWeight + ItemDefinition.ItemWeight * QuantityDelta, 0.f, MAX_FLT);
+		CurrentValue = FMath::Clamp(CurrentValue + ItemDefinition.ItemValue * QuantityDelta, 0.f, MAX_FLT);
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+void UElementusInventoryComponent::CheckWeightDrift()
+{
+	const int32 ValidationInterval = UElementusInventorySettings::Get()->WeightValidationInterval;
+	if (ValidationInterval <= 0 || ++MutationsSinceWeightValidation < ValidationInterval)
+	{
+		return;
+	}
+
+	MutationsSinceWeightValidation = 0;
+
+	const float IncrementalWeight = CurrentWeight;
+	ForceWeightUpdate();
+
+	if (!FMath::IsNearlyEqual(IncrementalWeight, CurrentWeight, FMath::Max(1.f, CurrentWeight) * KINDA_SMALL_NUMBER))
+	{
+		UE_LOG(LogElementusInventory, Warning, TEXT("%s: Actor %s had a weight drift: incremental %f, recomputed %f"), *FString(__FUNCTION__),
+		       *GetOwner()->GetName(), IncrementalWeight, CurrentWeight);
+	}
+}
+#endif
+
+void UElementusInventoryComponent::MarkSlotsDirty()
+{
+	bFreeSlotsDirty = true;
+}
+
+bool UElementusInventoryComponent::HasFixedSlots() const
+{
+	return bAllowEmptySlots && MaxNumItems > 0;
+}
+
+void UElementusInventoryComponent::FillFixedSlots()
+{
+	if (HasFixedSlots() && ItemSlots.Num() < MaxNumItems)
+	{
+		// A single run of empty slots, split as the items are placed
+		ItemSlots.SetNum(MaxNumItems);
+		MarkSlotsDirty();
+	}
+}
+
+void UElementusInventoryComponent::PlaceNewItem(const FElementusItemInfo& InItemInfo, const int32 NumSlots)
+{
+	int32 NumPlaced = 0;
+
+	if (bAllowEmptySlots)
+	{
+		if (bFreeSlotsDirty)
+		{
+			FreeSlots.Init(false, ItemSlots.Num());
+			LowestFreeSlot = ItemSlots.Num();
+
+			for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
+			{
+				if (!UElementusInventoryFunctions::IsItemValid(Iterator.ItemInfo))
+				{
+					FreeSlots.SetRange(Iterator.FirstSlot, Iterator.RunLength, true);
+					LowestFreeSlot = FMath::Min(LowestFreeSlot, Iterator.FirstSlot);
+				}
+			}
+
+			bFreeSlotsDirty = false;
+		}
+
+		const auto FindFreeSlot = [this](const int32 FromSlot)
+		{
+			const TConstSetBitIterator<> Iterator(FreeSlots, FMath::Min(FromSlot, FreeSlots.Num()));
+			return Iterator ? Iterator.GetIndex() : INDEX_NONE;
+		};
+
+		int32 Slot = FindFreeSlot(LowestFreeSlot);
+		for (; Slot != INDEX_NONE && NumPlaced < NumSlots; Slot = FindFreeSlot(Slot))
+		{
+			// Consecutive empty slots of the same run receive the copies as a single range
+			const FElementusItemRun& Run = ItemSlots.GetRuns()[ItemSlots.FindRunIndex(Slot)];
+
+			int32 RangeEnd = Slot + 1;
+			while (RangeEnd < Run.FirstSlot + Run.RunLength && NumPlaced + RangeEnd - Slot < NumSlots && FreeSlots[RangeEnd])
+			{
+				++RangeEnd;
+			}
+
+			const int32 RangeNum = RangeEnd - Slot;
+			SaveSlotsForRollback(Slot, RangeNum);
+
+			ItemSlots.SetRange(Slot, RangeNum, InItemInfo);
+
+			FreeSlots.SetRange(Slot, RangeNum, false);
+			NumPlaced += RangeNum;
+		}
+
+		// The search stopped at the lowest free slot left
+		LowestFreeSlot = Slot == INDEX_NONE ? FreeSlots.Num() : Slot;
+	}
+
+	if (const int32 NumNewSlots = NumSlots - NumPlaced; NumNewSlots > 0)
+	{
+		ItemSlots.Add(InItemInfo, NumNewSlots);
+
+		if (!bFreeSlotsDirty)
+		{
+			FreeSlots.Add(false, NumNewSlots);
+		}
+	}
+}
+
+void UElementusInventoryComponent::ReleaseSlots(const int32 FirstSlot, const int32 NumSlots)
+{
+	SaveSlotsForRollback(FirstSlot, NumSlots);
+
+	ItemSlots.SetRange(FirstSlot, NumSlots, FElementusItemInfo::EmptyItemInfo);
+
+	if (!bFreeSlotsDirty && FreeSlots.Num() >= FirstSlot + NumSlots)
+	{
+		FreeSlots.SetRange(FirstSlot, NumSlots, true);
+		LowestFreeSlot = FMath::Min(LowestFreeSlot, FirstSlot);
+	}
+}
+
+const FElementusInventoryIndex* UElementusInventoryComponent::GetItemIndex() const
+{
+	if (!bEnableItemIndexing)
+	{
+		return nullptr;
+	}
+
+	if (ItemIndex.IsDirty())
+	{
+		ItemIndex.Rebuild(ItemSlots);
+	}
+
+	return &ItemIndex;
+}
+
+void UElementusInventoryComponent::ForceInventoryValidation()
+{
+	ELEMENTUS_INVENTORY_SCOPE(ValidateInventory);
+
+	// Non-stackable items with more than one unit are expanded into a run of single units
+	TArray<FElementusItemRun> NewItems;
+	TArray<FElementusItemRun> RunsToRemove;
+
+	for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
+	{
+		if (Iterator.ItemInfo.Quantity <= 0)
+		{
+			RunsToRemove.Add(Iterator);
+		}
+
+		else if (Iterator.ItemInfo.Quantity > 1)
+		{
+			if (!UElementusInventoryFunctions::IsItemStackable(Iterator.ItemInfo))
+			{
+				NewItems.Emplace(FElementusItemInfo(Iterator.ItemInfo.ItemId, 1, Iterator.ItemInfo.Tags), Iterator.ItemInfo.Quantity * Iterator.RunLength);
+				RunsToRemove.Add(Iterator);
+			}
+		}
+	}
+
+	if (!UElementusInventoryFunctions::HasEmptyParam(RunsToRemove))
+	{
+		// Removing slots shifts all the next ones
+		SaveSlotsFromForRollback(RunsToRemove[0].FirstSlot);
+
+		// From the last one, so the slots of the previous ones don't move
+		for (int32 Iterator = RunsToRemove.Num() - 1; Iterator >= 0; --Iterator)
+		{
+			if (bAllowEmptySlots)
+			{
+				ItemSlots.SetRange(RunsToRemove[Iterator].FirstSlot, RunsToRemove[Iterator].RunLength, FElementusItemInfo::EmptyItemInfo);
+			}
+			else
+			{
+				ItemSlots.RemoveAt(RunsToRemove[Iterator].FirstSlot, RunsToRemove[Iterator].RunLength);
+			}
+		}
+	}
+	MarkSlotsDirty();
+
+	for (const FElementusItemRun& Iterator : NewItems)
+	{
+		PlaceNewItem(Iterator.ItemInfo, Iterator.RunLength);
+	}
+
+	NotifyInventoryChange();
+}
+
+static bool MatchesItemInfo(const FElementusItemInfo& InExistingInfo, const FElementusItemInfo& InItemInfo, const FGameplayTagContainer& IgnoreTags)
+{
+	if (IgnoreTags.IsEmpty())
+	{
+		return InExistingInfo == InItemInfo;
+	}
+
+	FElementusItemInfo InParamCopy(InItemInfo);
+	InParamCopy.Tags.RemoveTags(IgnoreTags);
+
+	FElementusItemInfo InExistingCopy(InExistingInfo);
+	InExistingCopy.Tags.RemoveTags(IgnoreTags);
+
+	return InExistingCopy == InParamCopy;
+}
+
+/* Find the first slot from the given offset whose item matches the predicate, evaluated once per run */
+template <typename PredicateType>
+static int32 FindFirstSlotInRuns(const FElementusItemSlots& InItems, const int32 Offset, PredicateType Predicate)
+{
+	const int32 FirstSlot = FMath::Max(Offset, 0);
+	if (!InItems.IsValidIndex(FirstSlot))
+	{
+		return INDEX_NONE;
+	}
+
+	const TArrayView<const FElementusItemRun> Runs = InItems.GetRuns();
+	for (int32 Iterator = InItems.FindRunIndex(FirstSlot); Iterator < Runs.Num(); ++Iterator)
+	{
+		if (Predicate(Runs[Iterator].ItemInfo))
+		{
+			return FMath::Max(Runs[Iterator].FirstSlot, FirstSlot);
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+/* Add all slots whose item matches the predicate, evaluated once per run */
+template <typename PredicateType>
+static void FindAllSlotsInRuns(const FElementusItemSlots& InItems, TArray<int32>& OutIndexes, PredicateType Predicate)
+{
+	for (const FElementusItemRun& Iterator : InItems.GetRuns())
+	{
+		if (Predicate(Iterator.ItemInfo))
+		{
+			for (int32 Slot = Iterator.FirstSlot; Slot < Iterator.FirstSlot + Iterator.RunLength; ++Slot)
+			{
+				OutIndexes.Add(Slot);
+			}
+		}
+	}
+}
+
+/* Find the first slot from the given offset in the indexed runs whose item matches the predicate, evaluated once per run */
+template <typename PredicateType>
+static int32 FindFirstSlotInIndexedRuns(const FElementusItemSlots& InItems, const TArrayView<const int64> RunKeys, const int32 Offset, PredicateType Predicate)
+{
+	const int32 FirstSlot = FMath::Max(Offset, 0);
+	if (!InItems.IsValidIndex(FirstSlot))
+	{
+		return INDEX_NONE;
+	}
+
+	const TArrayView<const FElementusItemRun> Runs = InItems.GetRuns();
+
+	// Keys follow the order of the slots, so the runs before the offset are skipped with a binary search
+	for (int32 Iterator = Algo::LowerBound(RunKeys, Runs[InItems.FindRunIndex(FirstSlot)].OrderKey); Iterator < RunKeys.Num(); ++Iterator)
+	{
+		if (const int32 RunIndex = InItems.FindRunIndexByKey(RunKeys[Iterator]); RunIndex != INDEX_NONE && Predicate(Runs[RunIndex].ItemInfo))
+		{
+			return FMath::Max(Runs[RunIndex].FirstSlot, FirstSlot);
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+/* Add all slots of the indexed runs whose item matches the predicate, evaluated once per run */
+template <typename PredicateType>
+static void FindAllSlotsInIndexedRuns(const FElementusItemSlots& InItems, const TArrayView<const int64> RunKeys, TArray<int32>& OutIndexes,
+                                      PredicateType Predicate)
+{
+	const TArrayView<const FElementusItemRun> Runs = InItems.GetRuns();
+
+	for (const int64 Iterator : RunKeys)
+	{
+		if (const int32 RunIndex = InItems.FindRunIndexByKey(Iterator); RunIndex != INDEX_NONE && Predicate(Runs[RunIndex].ItemInfo))
+		{
+			for (int32 Slot = Runs[RunIndex].FirstSlot; Slot < Runs[RunIndex].FirstSlot + Runs[RunIndex].RunLength; ++Slot)
+			{
+				OutIndexes.Add(Slot);
+			}
+		}
+	}
+}
+
+bool UElementusInventoryComponent::FindFirstItemIndexWithInfo(const FElementusItemInfo& InItemInfo, int32& OutIndex,
+                                                              const FGameplayTagContainer& IgnoreTags, const int32 Offset) const
+{
+	ELEMENTUS_INVENTORY_SCOPE(FindItems);
+
+	if (const FElementusInventoryIndex* const Index = GetItemIndex())
+	{
+		const TArray<int64>* const RunKeys = Index->FindRunsWithId(InItemInfo.ItemId);
+
+		OutIndex = RunKeys ? FindFirstSlotInIndexedRuns(ItemSlots, *RunKeys, Offset, [&InItemInfo, &IgnoreTags](const FElementusItemInfo& Item)
+		{
+			return MatchesItemInfo(Item, InItemInfo, IgnoreTags);
+		}) : INDEX_NONE;
+
+		return OutIndex != INDEX_NONE;
+	}
+
+	OutIndex = FindFirstSlotInRuns(ItemSlots, Offset, [&InItemInfo, &IgnoreTags](const FElementusItemInfo& Item)
+	{
+		return MatchesItemInfo(Item, InItemInfo, IgnoreTags);
+	});
+
+	return OutIndex != INDEX_NONE;
+}
+
+static bool HasAllTagsIgnoring(const FGameplayTagContainer& InTags, const FGameplayTagContainer& WithTags, const FGameplayTagContainer& IgnoreTags)
+{
+	// Same result as removing the ignored tags from a copy and calling HasAll, without copying the container
+	for (const FGameplayTag& RequiredTag : WithTags)
+	{
+		const bool bHasTag = InTags.GetGameplayTagArray().ContainsByPredicate([&RequiredTag, &IgnoreTags](const FGameplayTag& ExistingTag)
+		{
+			return ExistingTag.MatchesTag(RequiredTag) && !IgnoreTags.HasTagExact(ExistingTag);
+		});
+
+		if (!bHasTag)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool UElementusInventoryComponent::FindFirstItemIndexWithTags(const FGameplayTagContainer& WithTags, int32& OutIndex,
+                                                              const FGameplayTagContainer& IgnoreTags, const int32 Offset) const
+{
+	ELEMENTUS_INVENTORY_SCOPE(FindItems);
+
+	// Ignoring an exact tag that is also required can't produce any match
+	if (IgnoreTags.HasAnyExact(WithTags))
+	{
+		OutIndex = INDEX_NONE;
+		return false;
+	}
+
+	if (const FElementusInventoryIndex* const Index = GetItemIndex(); Index && !WithTags.IsEmpty())
+	{
+		TArray<int64> RunKeys;
+		OutIndex = Index->FindRunsWithAllTags(WithTags, RunKeys)
+			           ? FindFirstSlotInIndexedRuns(ItemSlots, RunKeys, Offset, [&WithTags](const FElementusItemInfo& Item)
+			           {
+				           return Item.Tags.HasAllExact(WithTags);
+			           })
+			           : INDEX_NONE;
+
+		return OutIndex != INDEX_NONE;
+	}
+
+	OutIndex = FindFirstSlotInRuns(ItemSlots, Offset, [&WithTags](const FElementusItemInfo& Item)
+	{
+		return Item.Tags.HasAllExact(WithTags);
+	});
+
+	return OutIndex != INDEX_NONE;
+}
+
+bool UElementusInventoryComponent::FindFirstItemIndexWithId(const FPrimaryElementusItemId& InId, int32& OutIndex,
+                                                            const FGameplayTagContainer& IgnoreTags, const int32 Offset) const
+{
+	ELEMENTUS_INVENTORY_SCOPE(FindItems);
+
+	if (const FElementusInventoryIndex* const Index = GetItemIndex())
+	{
+		const TArray<int64>* const RunKeys = Index->FindRunsWithId(InId);
+
+		OutIndex = RunKeys ? FindFirstSlotInIndexedRuns(ItemSlots, *RunKeys, Offset, [&IgnoreTags](const FElementusItemInfo& Item)
+		{
+			return !Item.Tags.HasAny(IgnoreTags);
+		}) : INDEX_NONE;
+
+		return OutIndex != INDEX_NONE;
+	}
+
+	OutIndex = FindFirstSlotInRuns(ItemSlots, Offset, [&InId, &IgnoreTags](const FElementusItemInfo& Item)
+	{
+		return !Item.Tags.HasAny(IgnoreTags) && Item.ItemId == InId;
+	});
+
+	return OutIndex != INDEX_NONE;
+}
+
+bool UElementusInventoryComponent::FindAllItemIndexesWithInfo(const FElementusItemInfo& InItemInfo, TArray<int32>& OutIndexes,
+                                                              const FGameplayTagContainer& IgnoreTags) const
+{
+	ELEMENTUS_INVENTORY_SCOPE(FindItems);
+
+	if (const FElementusInventoryIndex* const Index = GetItemIndex())
+	{
+		if (const TArray<int64>* const RunKeys = Index->FindRunsWithId(InItemInfo.ItemId))
+		{
+			FindAllSlotsInIndexedRuns(ItemSlots, *RunKeys, OutIndexes, [&InItemInfo, &IgnoreTags](const FElementusItemInfo& Item)
+			{
+				return MatchesItemInfo(Item, InItemInfo, IgnoreTags);
+			});
+		}
+
+		return !UElementusInventoryFunctions::HasEmptyParam(OutIndexes);
+	}
+
+	FindAllSlotsInRuns(ItemSlots, OutIndexes, [&InItemInfo, &IgnoreTags](const FElementusItemInfo& Item)
+	{
+		return MatchesItemInfo(Item, InItemInfo, IgnoreTags);
+	});
+
+	return !UElementusInventoryFunctions::HasEmptyParam(OutIndexes);
+}
+
+bool UElementusInventoryComponent::FindAllItemIndexesWithTags(const FGameplayTagContainer& WithTags, TArray<int32>& OutIndexes,
+                                                              const FGameplayTagContainer& IgnoreTags) const
+{
+	ELEMENTUS_INVENTORY_SCOPE(FindItems);
+
+	if (const FElementusInventoryIndex* const Index = GetItemIndex(); Index && !WithTags.IsEmpty())
+	{
+		if (TArray<int64> RunKeys; Index->FindRunsWithAllTags(WithTags, RunKeys))
+		{
+			FindAllSlotsInIndexedRuns(ItemSlots, RunKeys, OutIndexes, [&WithTags, &IgnoreTags](const FElementusItemInfo& Item)
+			{
+				return HasAllTagsIgnoring(Item.Tags, WithTags, IgnoreTags);
+			});
+		}
+
+		return !UElementusInventoryFunctions::HasEmptyParam(OutIndexes);
+	}
+
+	FindAllSlotsInRuns(ItemSlots, OutIndexes, [&WithTags, &IgnoreTags](const FElementusItemInfo& Item)
+	{
+		return HasAllTagsIgnoring(Item.Tags, WithTags, IgnoreTags);
+	});
+
+	return !UElementusInventoryFunctions::HasEmptyParam(OutIndexes);
+}
+
+bool UElementusInventoryComponent::FindAllItemIndexesWithId(const FPrimaryElementusItemId& InId, TArray<int32>& OutIndexes,
+                                                            const FGameplayTagContainer& IgnoreTags) const
+{
+	ELEMENTUS_INVENTORY_SCOPE(FindItems);
+
+	if (const FElementusInventoryIndex* const Index = GetItemIndex())
+	{
+		if (const TArray<int64>* const RunKeys = Index->FindRunsWithId(InId))
+		{
+			FindAllSlotsInIndexedRuns(ItemSlots, *RunKeys, OutIndexes, [&IgnoreTags](const FElementusItemInfo& Item)
+			{
+				return !Item.Tags.HasAll(IgnoreTags);
+			});
+		}
+
+		return !UElementusInventoryFunctions::HasEmptyParam(OutIndexes);
+	}
+
+	FindAllSlotsInRuns(ItemSlots, OutIndexes, [&InId, &IgnoreTags](const FElementusItemInfo& Item)
+	{
+		return !Item.Tags.HasAll(IgnoreTags) && Item.ItemId == InId;
+	});
+
+	return !UElementusInventoryFunctions::HasEmptyParam(OutIndexes);
+}
+
+bool UElementusInventoryComponent::ContainsItem(const FElementusItemInfo& InItemInfo, const bool bIgnoreTags) const
+{
+	ELEMENTUS_INVENTORY_SCOPE(FindItems);
+
+	if (const FElementusInventoryIndex* const Index = GetItemIndex())
+	{
+		const TArray<int64>* const RunKeys = Index->FindRunsWithId(InItemInfo.ItemId);
+		if (!RunKeys)
+		{
+			return false;
+		}
+
+		if (bIgnoreTags)
+		{
+			return !UElementusInventoryFunctions::HasEmptyParam(*RunKeys);
+		}
+
+		return RunKeys->ContainsByPredicate([this, &InItemInfo](const int64 InKey)
+		{
+			const int32 RunIndex = ItemSlots.FindRunIndexByKey(InKey);
+			return RunIndex != INDEX_NONE && ItemSlots.GetRuns()[RunIndex].ItemInfo == InItemInfo;
+		});
+	}
+
+	return ItemSlots.GetRuns().ContainsByPredicate([&InItemInfo, &bIgnoreTags](const FElementusItemRun& InRun)
+	{
+		if (bIgnoreTags)
+		{
+			return InRun.ItemInfo.ItemId == InItemInfo.ItemId;
+		}
+
+		return InRun.ItemInfo == InItemInfo;
+	});
+}
+
+bool UElementusInventoryComponent::IsInventoryEmpty() const
+{
+	bool bOutput = true;
+
+	for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
+	{
+		if (Iterator.ItemInfo.Quantity > 0)
+		{
+			bOutput = false;
+			break;
+		}
+	}
+
+	return bOutput;
+}
+
+void UElementusInventoryComponent::DebugInventory()
+{
+#if !UE_BUILD_SHIPPING
+	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("%s"), *FString(__FUNCTION__));
+	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Owning Actor: %s"), *GetOwner()->GetName());
+
+	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Weight: %f"), CurrentWeight);
+	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Num: %i"), ItemSlots.Num());
+	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Size: %i"), ItemSlots.GetAllocatedSize());
+
+	for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
+	{
+		UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Item: %s"), *Iterator.ItemInfo.ItemId.ToString());
+		UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Quantity: %i"), Iterator.ItemInfo.Quantity);
+		UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Slots: %i"), Iterator.RunLength);
+
+		for (const FGameplayTag& Tag : Iterator.ItemInfo.Tags)
 		{
-			OutIndex = Iterator;
-			return true;
+			UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Tag: %s"), *Tag.ToString());
 		}
 	}
 
-	OutIndex = INDEX_NONE;
-	return false;
+	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Component Memory Size: %ull"), GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
+#endif
 }
 
-bool UElementusInventoryComponent::FindFirstItemIndexWithId(const FPrimaryElementusItemId& InId, int32& OutIndex,
-                                                            const FGameplayTagContainer& IgnoreTags, const int32 Offset) const
+void UElementusInventoryComponent::ClearInventory()
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		FElementusInventoryCommand Command;
+		Command.Type = EElementusInventoryCommandType::ClearInventory;
+
+		QueueInventoryCommand(MoveTemp(Command));
+		return;
+	}
+
+	UE_LOG(LogElementusInventory, Display, TEXT("%s: Cleaning %s's inventory"), *FString(__FUNCTION__), *GetOwner()->GetName());
+
+	SaveSlotsFromForRollback(0);
+
+	ItemSlots.Empty();
+	ItemIndex.Reset();
+	bFreeSlotsDirty = true;
+	FillFixedSlots();
+
+	CurrentWeight = 0.f;
+	CurrentValue = 0.f;
+
+	// Clients receive the removed slots with the replicated items, once the transaction is committed if there's one in progress
+	NotifyInventoryChange();
+}
+
+void UElementusInventoryComponent::GetItemIndexesFrom(UElementusInventoryComponent* OtherInventory, const TArray<int32>& ItemIndexes)
 {
-	for (int32 Iterator = Offset; Iterator < ElementusItems.Num(); ++Iterator)
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		FElementusInventoryCommand Command;
+		Command.Type = EElementusInventoryCommandType::GetItemIndexesFrom;
+		Command.OtherInventory = OtherInventory;
+		Command.ItemIndexes = ItemIndexes;
+
+		QueueInventoryCommand(MoveTemp(Command));
+		return;
+	}
+
+	if (!IsValid(OtherInventory))
+	{
+		return;
+	}
+
+	TArray<FElementusItemInfo> Modifiers;
+	for (const int32& Iterator : ItemIndexes)
 	{
-		if (!ElementusItems[Iterator].Tags.HasAny(IgnoreTags) && ElementusItems[Iterator].ItemId == InId)
+		if (OtherInventory->ItemSlots.IsValidIndex(Iterator))
 		{
-			OutIndex = Iterator;
-			return true;
+			Modifiers.Add(OtherInventory->ItemSlots[Iterator]);
 		}
 	}
 
-	OutIndex = INDEX_NONE;
-	return false;
+	GetItemsFrom(OtherInventory, Modifiers);
 }
 
-bool UElementusInventoryComponent::FindAllItemIndexesWithInfo(const FElementusItemInfo& InItemInfo, TArray<int32>& OutIndexes,
-                                                              const FGameplayTagContainer& IgnoreTags) const
+void UElementusInventoryComponent::GiveItemIndexesTo(UElementusInventoryComponent* OtherInventory, const TArray<int32>& ItemIndexes)
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		FElementusInventoryCommand Command;
+		Command.Type = EElementusInventoryCommandType::GiveItemIndexesTo;
+		Command.OtherInventory = OtherInventory;
+		Command.ItemIndexes = ItemIndexes;
+
+		QueueInventoryCommand(MoveTemp(Command));
+		return;
+	}
+
+	if (!IsValid(OtherInventory))
+	{
+		return;
+	}
+
+	TArray<FElementusItemInfo> Modifiers;
+	for (const int32& Iterator : ItemIndexes)
+	{
+		if (ItemSlots.IsValidIndex(Iterator))
+		{
+			Modifiers.Add(ItemSlots[Iterator]);
+		}
+	}
+
+	GiveItemsTo(OtherInventory, Modifiers);
+}
+
+void UElementusInventoryComponent::GetItemsFrom(UElementusInventoryComponent* OtherInventory, const TArray<FElementusItemInfo>& Items)
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		FElementusInventoryCommand Command;
+		Command.Type = EElementusInventoryCommandType::GetItemsFrom;
+		Command.OtherInventory = OtherInventory;
+		Command.Items = Items;
+
+		QueueInventoryCommand(MoveTemp(Command));
+		return;
+	}
+
+	if (!IsValid(OtherInventory))
+	{
+		return;
+	}
+
+	TArray<EElementusTradeItemResult> Results;
+	UElementusInventoryFunctions::TradeItems(OtherInventory, this, Items, Results);
+}
+
+void UElementusInventoryComponent::GiveItemsTo(UElementusInventoryComponent* OtherInventory, const TArray<FElementusItemInfo>& Items)
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		FElementusInventoryCommand Command;
+		Command.Type = EElementusInventoryCommandType::GiveItemsTo;
+		Command.OtherInventory = OtherInventory;
+		Command.Items = Items;
+
+		QueueInventoryCommand(MoveTemp(Command));
+		return;
+	}
+
+	if (!IsValid(OtherInventory))
+	{
+		return;
+	}
+
+	TArray<EElementusTradeItemResult> Results;
+	UElementusInventoryFunctions::TradeItems(this, OtherInventory, Items, Results);
+}
+
+void UElementusInventoryComponent::DiscardItemIndexes(const TArray<int32>& ItemIndexes)
+{
+	if (UElementusInventoryFunctions::HasEmptyParam(ItemIndexes))
+	{
+		return;
+	}
+
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		FElementusInventoryCommand Command;
+		Command.Type = EElementusInventoryCommandType::DiscardItemIndexes;
+		Command.ItemIndexes = ItemIndexes;
+
+		QueueInventoryCommand(MoveTemp(Command));
+		return;
+	}
+
+	TArray<FElementusItemInfo> Modifiers;
+	for (const int32& Iterator : ItemIndexes)
+	{
+		if (ItemSlots.IsValidIndex(Iterator))
+		{
+			Modifiers.Add(ItemSlots[Iterator]);
+		}
+	}
+
+	DiscardItems(Modifiers);
+}
+
+void UElementusInventoryComponent::DiscardItems(const TArray<FElementusItemInfo>& Items)
+{
+	if (UElementusInventoryFunctions::HasEmptyParam(Items))
+	{
+		return;
+	}
+
+	UpdateElementusItems(Items, EElementusInventoryUpdateOperation::Remove);
+}
+
+void UElementusInventoryComponent::AddItems(const TArray<FElementusItemInfo>& Items)
+{
+	if (UElementusInventoryFunctions::HasEmptyParam(Items))
+	{
+		return;
+	}
+
+	UpdateElementusItems(Items, EElementusInventoryUpdateOperation::Add);
+}
+
+void UElementusInventoryComponent::QueueInventoryCommand(FElementusInventoryCommand&& Command)
+{
+	const UWorld* const World = GetWorld();
+	if (!IsValid(World))
+	{
+		return;
+	}
+
+	// The first command of the frame schedules the flush, the following ones are sent with it
+	if (UElementusInventoryFunctions::HasEmptyParam(PendingCommands))
+	{
+		World->GetTimerManager().SetTimerForNextTick(this, &UElementusInventoryComponent::FlushInventoryCommands);
+	}
+
+	PendingCommands.Add(MoveTemp(Command));
+}
+
+void UElementusInventoryComponent::FlushInventoryCommands()
+{
+	if (UElementusInventoryFunctions::HasEmptyParam(PendingCommands))
+	{
+		return;
+	}
+
+	UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Sending %d inventory command(s) from %s"), *FString(__FUNCTION__), PendingCommands.Num(),
+	       *GetOwner()->GetName());
+
+	Server_ProcessInventoryCommands(PendingCommands);
+	PendingCommands.Reset();
+}
+
+void UElementusInventoryComponent::Server_ProcessInventoryCommands_Implementation(const TArray<FElementusInventoryCommand>& Commands)
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	// All commands of the client frame are validated, replicated and notified as a single update
+	FElementusInventoryScopedTransaction Transaction(this);
+
+	for (const FElementusInventoryCommand& Iterator : Commands)
+	{
+		if (!IsValidClientCommand(Iterator))
+		{
+			UE_LOG(LogElementusInventory, Warning, TEXT("%s: Rejected an invalid inventory command from %s"), *FString(__FUNCTION__), *GetOwner()->GetName());
+			continue;
+		}
+
+		ExecuteInventoryCommand(Iterator);
+	}
+}
+
+bool UElementusInventoryComponent::IsValidClientCommand(const FElementusInventoryCommand& Command) const
+{
+	const FElementusItemSlots* IndexedItems = &ItemSlots;
+
+	switch (Command.Type)
+	{
+	case EElementusInventoryCommandType::AddItems:
+	case EElementusInventoryCommandType::DiscardItems:
+	case EElementusInventoryCommandType::DiscardItemIndexes:
+	case EElementusInventoryCommandType::ClearInventory:
+		break;
+
+	case EElementusInventoryCommandType::GetItemIndexesFrom:
+		if (!CanClientInteractWith(Command.OtherInventory))
+		{
+			return false;
+		}
+
+		IndexedItems = &Command.OtherInventory->ItemSlots;
+		break;
+
+	case EElementusInventoryCommandType::GiveItemsTo:
+	case EElementusInventoryCommandType::GetItemsFrom:
+	case EElementusInventoryCommandType::GiveItemIndexesTo:
+		if (!CanClientInteractWith(Command.OtherInventory))
+		{
+			return false;
+		}
+
+		break;
+
+	default:
+		return false;
+	}
+
+	// Ids unknown to the cache, the catalog and the Asset Manager would otherwise reach a synchronous load and be remembered as missing
+	if (Command.Items.ContainsByPredicate([](const FElementusItemInfo& InItem)
+	{
+		return !FElementusItemDefinitionCache::Get().IsKnownItemId(InItem.ItemId);
+	}))
+	{
+		return false;
+	}
+
+	return !Command.ItemIndexes.ContainsByPredicate([IndexedItems](const int32 Index)
+	{
+		return !IndexedItems->IsValidIndex(Index);
+	});
+}
+
+bool UElementusInventoryComponent::CanClientInteractWith(const UElementusInventoryComponent* OtherInventory) const
+{
+	if (!IsValid(OtherInventory) || OtherInventory == this || OtherInventory->GetWorld() != GetWorld())
+	{
+		return false;
+	}
+
+	const AActor* const Owner = GetOwner();
+	const AActor* const OtherOwner = OtherInventory->GetOwner();
+	if (!IsValid(Owner) || !IsValid(OtherOwner))
+	{
+		return false;
+	}
+
+	if (const UNetConnection* const Connection = Owner->GetNetConnection(); Connection && Connection == OtherOwner->GetNetConnection())
+	{
+		return true;
+	}
+
+	const float MaxDistance = UElementusInventorySettings::Get()->MaxClientInteractionDistance;
+	return MaxDistance > 0.f && FVector::DistSquared(Owner->GetActorLocation(), OtherOwner->GetActorLocation()) <= FMath::Square(MaxDistance);
+}
+
+void UElementusInventoryComponent::ExecuteInventoryCommand(const FElementusInventoryCommand& Command)
+{
+	switch (Command.Type)
+	{
+	case EElementusInventoryCommandType::AddItems:
+		AddItems(Command.Items);
+		break;
+
+	case EElementusInventoryCommandType::DiscardItems:
+		DiscardItems(Command.Items);
+		break;
+
+	case EElementusInventoryCommandType::DiscardItemIndexes:
+		DiscardItemIndexes(Command.ItemIndexes);
+		break;
+
+	case EElementusInventoryCommandType::GiveItemsTo:
+		GiveItemsTo(Command.OtherInventory, Command.Items);
+		break;
+
+	case EElementusInventoryCommandType::GetItemsFrom:
+		GetItemsFrom(Command.OtherInventory, Command.Items);
+		break;
+
+	case EElementusInventoryCommandType::GiveItemIndexesTo:
+		GiveItemIndexesTo(Command.OtherInventory, Command.ItemIndexes);
+		break;
+
+	case EElementusInventoryCommandType::GetItemIndexesFrom:
+		GetItemIndexesFrom(Command.OtherInventory, Command.ItemIndexes);
+		break;
+
+	case EElementusInventoryCommandType::ClearInventory:
+		ClearInventory();
+		break;
+
+	default:
+		break;
+	}
+}
+
+void UElementusInventoryComponent::UpdateElementusItems(const TArray<FElementusItemInfo>& Modifiers,
+                                                        const EElementusInventoryUpdateOperation Operation)
 {
-	for (auto Iterator = ElementusItems.CreateConstIterator(); Iterator; ++Iterator)
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		// The server resolves the slots with its own items
+		FElementusInventoryCommand Command;
+		Command.Type = Operation == EElementusInventoryUpdateOperation::Add ? EElementusInventoryCommandType::AddItems : EElementusInventoryCommandType::DiscardItems;
+		Command.Items = Modifiers;
+
+		QueueInventoryCommand(MoveTemp(Command));
+		return;
+	}
+
+	TArray<FItemModifierData> ModifierDataArr;
+
+	const FString OpStr = Operation == EElementusInventoryUpdateOperation::Add ? "Add" : "Remove";
+	const FString OpPred = Operation == EElementusInventoryUpdateOperation::Add ? "to" : "from";
+
+	// Quantity already taken from each slot by the previous modifiers
+	TMap<int32, int32> RemovedQuantities;
+
+	for (const FElementusItemInfo& Iterator : Modifiers)
 	{
-		if (IgnoreTags.IsEmpty() && *Iterator == InItemInfo)
+		UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: %s %d item(s) with name '%s' %s inventory"), *FString(__FUNCTION__), *OpStr,
+		       Iterator.Quantity, *Iterator.ItemId.ToString(), *OpPred);
+
+		if (Operation != EElementusInventoryUpdateOperation::Remove)
 		{
-			OutIndexes.Add(Iterator.GetIndex());
+			// The slot of stackable items is resolved when adding them, since a previous modifier may have placed the same item
+			ModifierDataArr.Add(FItemModifierData(Iterator));
 			continue;
 		}
 
-		FElementusItemInfo InItCopy(*Iterator);
-		InItCopy.Tags.RemoveTags(IgnoreTags);
+		// The quantity may be split across many slots, like non-stackable items or separate stacks: take it from all matching slots in order
+		int32 RemainingQuantity = Iterator.Quantity;
 
-		FElementusItemInfo InParamCopy(InItemInfo);
-		InParamCopy.Tags.RemoveTags(IgnoreTags);
+		TArray<int32> Indexes;
+		FindAllItemIndexesWithInfo(Iterator, Indexes, FGameplayTagContainer::EmptyContainer);
 
-		if (InItCopy == InParamCopy)
+		for (const int32 Index : Indexes)
 		{
-			OutIndexes.Add(Iterator.GetIndex());
-		}
-	}
+			if (RemainingQuantity <= 0)
+			{
+				break;
+			}
 
-	return !UElementusInventoryFunctions::HasEmptyParam(OutIndexes);
-}
+			int32& RemovedQuantity = RemovedQuantities.FindOrAdd(Index);
+			if (const int32 SlotQuantity = FMath::Min(ItemSlots[Index].Quantity - RemovedQuantity, RemainingQuantity); SlotQuantity > 0)
+			{
+				FElementusItemInfo SlotModifier(Iterator);
+				SlotModifier.Quantity = SlotQuantity;
 
-bool UElementusInventoryComponent::FindAllItemIndexesWithTags(const FGameplayTagContainer& WithTags, TArray<int32>& OutIndexes,
-                                                              const FGameplayTagContainer& IgnoreTags) const
-{
-	for (auto Iterator = ElementusItems.CreateConstIterator(); Iterator; ++Iterator)
-	{
-		FElementusItemInfo InCopy(*Iterator);
-		if (!IgnoreTags.IsEmpty())
-		{
-			InCopy.Tags.RemoveTags(IgnoreTags);
-		}
+				ModifierDataArr.Add(FItemModifierData(SlotModifier, Index));
 
-		if (InCopy.Tags.HasAll(WithTags))
-		{
-			OutIndexes.Add(Iterator.GetIndex());
+				RemovedQuantity += SlotQuantity;
+				RemainingQuantity -= SlotQuantity;
+			}
 		}
-	}
 
-	return !UElementusInventoryFunctions::HasEmptyParam(OutIndexes);
-}
-
-bool UElementusInventoryComponent::FindAllItemIndexesWithId(const FPrimaryElementusItemId& InId, TArray<int32>& OutIndexes,
-                                                            const FGameplayTagContainer& IgnoreTags) const
-{
-	for (auto Iterator = ElementusItems.CreateConstIterator(); Iterator; ++Iterator)
-	{
-		if (!Iterator->Tags.HasAll(IgnoreTags) && Iterator->ItemId == InId)
+		if (RemainingQuantity > 0)
 		{
-			OutIndexes.Add(Iterator.GetIndex());
+			UE_LOG(LogElementusInventory_Internal, Warning, TEXT("%s: Missing %d item(s) with name '%s' in inventory"), *FString(__FUNCTION__),
+			       RemainingQuantity, *Iterator.ItemId.ToString());
 		}
 	}
 
-	return !UElementusInventoryFunctions::HasEmptyParam(OutIndexes);
-}
-
-bool UElementusInventoryComponent::ContainsItem(const FElementusItemInfo& InItemInfo, const bool bIgnoreTags) const
-{
-	return ElementusItems.FindByPredicate([&InItemInfo, &bIgnoreTags](const FElementusItemInfo& InInfo)
+	switch (Operation)
 	{
-		if (bIgnoreTags)
-		{
-			return InInfo.ItemId == InItemInfo.ItemId;
-		}
+	case EElementusInventoryUpdateOperation::Add:
+		ProcessInventoryAddition_Internal(ModifierDataArr);
+		break;
+
+	case EElementusInventoryUpdateOperation::Remove:
+		ProcessInventoryRemoval_Internal(ModifierDataArr);
+		break;
 
-		return InInfo == InItemInfo;
-	}) != nullptr;
+	default:
+		break;
+	}
 }
 
-bool UElementusInventoryComponent::IsInventoryEmpty() const
+void UElementusInventoryComponent::ProcessInventoryAddition_Internal(const TArray<FItemModifierData>& Modifiers)
 {
-	bool bOutput = true;
+	ELEMENTUS_INVENTORY_SCOPE(AddItems);
 
-	for (const FElementusItemInfo& Iterator : ElementusItems)
+	if (GetOwnerRole() != ROLE_Authority)
 	{
-		if (Iterator.Quantity > 0)
-		{
-			bOutput = false;
-			break;
-		}
+		return;
 	}
 
-	return bOutput;
-}
-
-void UElementusInventoryComponent::DebugInventory()
-{
-#if !UE_BUILD_SHIPPING
-	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("%s"), *FString(__FUNCTION__));
-	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Owning Actor: %s"), *GetOwner()->GetName());
+	for (const FItemModifierData& Iterator : Modifiers)
+	{
+		ApplyItemWeightDelta(Iterator.ItemInfo.ItemId, FMath::Max(Iterator.ItemInfo.Quantity, 0));
 
-	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Weight: %f"), CurrentWeight);
-	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Num: %i"), ElementusItems.Num());
-	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Size: %i"), ElementusItems.GetAllocatedSize());
+		int32 Index = INDEX_NONE;
+		if (const bool bIsStackable = UElementusInventoryFunctions::IsItemStackable(Iterator.ItemInfo); bIsStackable && FindFirstItemIndexWithInfo(
+			Iterator.ItemInfo, Index, FGameplayTagContainer::EmptyContainer))
+		{
+			SaveSlotsForRollback(Index);
 
-	for (const FElementusItemInfo& Iterator : ElementusItems)
-	{
-		UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Item: %s"), *Iterator.ItemId.ToString());
-		UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Quantity: %i"), Iterator.Quantity);
+			FElementusItemInfo StackedItem = ItemSlots[Index];
+			StackedItem.Quantity += Iterator.ItemInfo.Quantity;
 
-		for (const FGameplayTag& Tag : Iterator.Tags)
+			ItemSlots.Set(Index, StackedItem);
+		}
+		else if (!bIsStackable)
 		{
-			UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Tag: %s"), *Tag.ToString());
+			PlaceNewItem(FElementusItemInfo(Iterator.ItemInfo.ItemId, 1, Iterator.ItemInfo.Tags), Iterator.ItemInfo.Quantity);
+		}
+		else
+		{
+			PlaceNewItem(Iterator.ItemInfo);
 		}
 	}
 
-	UE_LOG(LogElementusInventory_Internal, Warning, TEXT("Component Memory Size: %ull"), GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
+#if !UE_BUILD_SHIPPING
+	CheckWeightDrift();
 #endif
-}
-
-void UElementusInventoryComponent::ClearInventory_Implementation()
-{
-	UE_LOG(LogElementusInventory, Display, TEXT("%s: Cleaning %s's inventory"), *FString(__FUNCTION__), *GetOwner()->GetName());
 
-	ElementusItems.Empty();
-	CurrentWeight = 0.f;
+	NotifyInventoryChange();
 }
 
-void UElementusInventoryComponent::GetItemIndexesFrom_Implementation(UElementusInventoryComponent* OtherInventory, const TArray<int32>& ItemIndexes)
+void UElementusInventoryComponent::ProcessInventoryRemoval_Internal(const TArray<FItemModifierData>& Modifiers)
 {
+	ELEMENTUS_INVENTORY_SCOPE(RemoveItems);
+
 	if (GetOwnerRole() != ROLE_Authority)
 	{
 		return;
 	}
 
-	TArray<FElementusItemInfo> Modifiers;
-	for (const int32& Iterator : ItemIndexes)
+	for (const FItemModifierData& Iterator : Modifiers)
 	{
-		if (OtherInventory->ElementusItems.IsValidIndex(Iterator))
+		if (!ItemSlots.IsValidIndex(Iterator.Index))
 		{
-			Modifiers.Add(OtherInventory->ElementusItems[Iterator]);
+			UE_LOG(LogElementusInventory_Internal, Warning, TEXT("%s: Item with name '%s' not found in inventory"), *FString(__FUNCTION__),
+			       *Iterator.ItemInfo.ItemId.ToString());
+
+			continue;
 		}
-	}
 
-	GetItemsFrom_Implementation(OtherInventory, Modifiers);
-}
+		SaveSlotsForRollback(Iterator.Index);
 
-void UElementusInventoryComponent::GiveItemIndexesTo_Implementation(UElementusInventoryComponent* OtherInventory, const TArray<int32>& ItemIndexes)
-{
-	if (GetOwnerRole() != ROLE_Authority)
-	{
-		return;
+		FElementusItemInfo ExistingItem = ItemSlots[Iterator.Index];
+		const int32 RemovedQuantity = FMath::Min(ExistingItem.Quantity, Iterator.ItemInfo.Quantity);
+
+		ApplyItemWeightDelta(ExistingItem.ItemId, -FMath::Max(RemovedQuantity, 0));
+		ExistingItem.Quantity -= Iterator.ItemInfo.Quantity;
+
+		ItemSlots.Set(Iterator.Index, ExistingItem);
 	}
 
-	TArray<FElementusItemInfo> Modifiers;
-	for (const int32& Iterator : ItemIndexes)
+	if (bAllowEmptySlots)
 	{
-		if (OtherInventory->ElementusItems.IsValidIndex(Iterator))
+		// Collected before releasing them, since the released runs may be merged with their neighbors
+		TArray<FElementusItemRun> EmptiedRuns;
+		for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
+		{
+			if (Iterator.ItemInfo.Quantity <= 0 && Iterator.ItemInfo != FElementusItemInfo::EmptyItemInfo)
+			{
+				EmptiedRuns.Add(Iterator);
+			}
+		}
+
+		for (const FElementusItemRun& Iterator : EmptiedRuns)
 		{
-			Modifiers.Add(ElementusItems[Iterator]);
+			ReleaseSlots(Iterator.FirstSlot, Iterator.RunLength);
 		}
 	}
+	else if (const FElementusItemRun* const FirstRemovedRun = ItemSlots.GetRuns().FindByPredicate([](const FElementusItemRun& InRun)
+	{
+		return InRun.ItemInfo.Quantity <= 0;
+	}))
+	{
+		// Removing slots shifts all the next ones
+		SaveSlotsFromForRollback(FirstRemovedRun->FirstSlot);
+
+		ItemSlots.RemoveAll([](const FElementusItemInfo& InInfo)
+		{
+			return InInfo.Quantity <= 0;
+		});
+
+		MarkSlotsDirty();
+	}
 
-	GiveItemsTo_Implementation(OtherInventory, Modifiers);
+#if !UE_BUILD_SHIPPING
+	CheckWeightDrift();
+#endif
+
+	NotifyInventoryChange();
 }
 
-void UElementusInventoryComponent::GetItemsFrom_Implementation(UElementusInventoryComponent* OtherInventory, const TArray<FElementusItemInfo>& Items)
+void UElementusInventoryComponent::ApplyReplicatedEntry(const FElementusReplicatedItem& InEntry, const EElementusInventorySlotUpdate UpdateType)
 {
-	if (GetOwnerRole() != ROLE_Authority)
+	// The authority is the source of the replicated entries
+	if (GetOwnerRole() == ROLE_Authority)
 	{
 		return;
 	}
 
-	if (!IsValid(OtherInventory))
+	const int32 RunIndex = ItemSlots.FindRunIndexByKey(InEntry.OrderKey);
+
+	if (UpdateType == EElementusInventorySlotUpdate::Removed || InEntry.RunLength <= 0)
 	{
+		if (RunIndex != INDEX_NONE)
+		{
+			SaveRunsBeforeReplication(ItemSlots.GetRuns()[RunIndex].FirstSlot);
+			ItemSlots.RemoveRun(RunIndex);
+		}
+
 		return;
 	}
 
-	const TArray<FElementusItemInfo> TradeableItems = UElementusInventoryFunctions::FilterTradeableItems(OtherInventory, this, Items);
+	if (RunIndex == INDEX_NONE)
+	{
+		// The new run is placed before the first run with a greater key
+		const TArrayView<const FElementusItemRun> Runs = ItemSlots.GetRuns();
+		const int32 NextRun = Algo::LowerBoundBy(Runs, InEntry.OrderKey, &FElementusItemRun::OrderKey);
 
-	OtherInventory->UpdateElementusItems(TradeableItems, EElementusInventoryUpdateOperation::Remove);
-	UpdateElementusItems(TradeableItems, EElementusInventoryUpdateOperation::Add);
-}
+		SaveRunsBeforeReplication(Runs.IsValidIndex(NextRun) ? Runs[NextRun].FirstSlot : ItemSlots.Num());
+		ItemSlots.InsertRunWithKey(InEntry.OrderKey, InEntry.ItemInfo, InEntry.RunLength);
 
-void UElementusInventoryComponent::GiveItemsTo_Implementation(UElementusInventoryComponent* OtherInventory, const TArray<FElementusItemInfo>& Items)
-{
-	if (GetOwnerRole() != ROLE_Authority)
-	{
 		return;
 	}
 
-	if (!IsValid(OtherInventory))
+	const FElementusItemRun& Run = ItemSlots.GetRuns()[RunIndex];
+
+	// Resizing a run moves all the next slots, which are compared once the whole update is applied
+	if (Run.RunLength != InEntry.RunLength || Run.FirstSlot >= FirstSlotChangedByReplication)
 	{
+		SaveRunsBeforeReplication(Run.FirstSlot);
+		ItemSlots.SetRun(RunIndex, InEntry.ItemInfo, InEntry.RunLength);
+
 		return;
 	}
 
-	const TArray<FElementusItemInfo> TradeableItems = UElementusInventoryFunctions::FilterTradeableItems(this, OtherInventory, Items);
+	// Changing the item of a run in place only changes its own slots
+	if (!FElementusItemRun::HasSameContent(Run.ItemInfo, InEntry.ItemInfo))
+	{
+		FElementusItemRun NewRun(InEntry.ItemInfo, InEntry.RunLength);
+		NewRun.FirstSlot = Run.FirstSlot;
 
-	UpdateElementusItems(TradeableItems, EElementusInventoryUpdateOperation::Remove);
-	OtherInventory->UpdateElementusItems(TradeableItems, EElementusInventoryUpdateOperation::Add);
+		QueueSlotUpdates(MakeArrayView(&Run, 1), MakeArrayView(&NewRun, 1), true);
+		ItemSlots.SetRun(RunIndex, InEntry.ItemInfo, InEntry.RunLength);
+	}
 }
 
-void UElementusInventoryComponent::DiscardItemIndexes_Implementation(const TArray<int32>& ItemIndexes)
+void UElementusInventoryComponent::SaveRunsBeforeReplication(const int32 FirstSlot)
 {
-	if (GetOwnerRole() != ROLE_Authority || UElementusInventoryFunctions::HasEmptyParam(ItemIndexes))
+	if (FirstSlotChangedByReplication == INDEX_NONE)
 	{
-		return;
+		FirstSlotChangedByReplication = ItemSlots.Num();
+		RunsBeforeReplication.Reset();
 	}
 
-	TArray<FElementusItemInfo> Modifiers;
-	for (const int32& Iterator : ItemIndexes)
+	if (FirstSlot >= FirstSlotChangedByReplication)
 	{
-		if (ElementusItems.IsValidIndex(Iterator))
-		{
-			Modifiers.Add(ElementusItems[Iterator]);
-		}
+		return;
 	}
 
-	DiscardItems(Modifiers);
-}
+	// Each change only moves the slots after it, so the slots before the first changed one still hold their previous items
+	TArray<FElementusItemRun> SavedRuns;
 
-void UElementusInventoryComponent::DiscardItems_Implementation(const TArray<FElementusItemInfo>& Items)
-{
-	if (GetOwnerRole() != ROLE_Authority || UElementusInventoryFunctions::HasEmptyParam(Items))
+	const TArrayView<const FElementusItemRun> Runs = ItemSlots.GetRuns();
+	for (int32 Iterator = ItemSlots.FindRunIndex(FirstSlot); Iterator < Runs.Num() && Runs[Iterator].FirstSlot < FirstSlotChangedByReplication; ++Iterator)
 	{
-		return;
+		SavedRuns.Add(Runs[Iterator]);
 	}
 
-	UpdateElementusItems(Items, EElementusInventoryUpdateOperation::Remove);
+	RunsBeforeReplication.Insert(SavedRuns, 0);
+	FirstSlotChangedByReplication = FirstSlot;
 }
 
-void UElementusInventoryComponent::AddItems_Implementation(const TArray<FElementusItemInfo>& Items)
+void UElementusInventoryComponent::QueueReplicatedSlotUpdates()
 {
-	if (GetOwnerRole() != ROLE_Authority || UElementusInventoryFunctions::HasEmptyParam(Items))
+	if (FirstSlotChangedByReplication == INDEX_NONE)
 	{
 		return;
 	}
 
-	UpdateElementusItems(Items, EElementusInventoryUpdateOperation::Add);
+	// Only the slots from the first one moved by this update are compared
+	const TArrayView<const FElementusItemRun> Runs = ItemSlots.GetRuns();
+	const int32 FirstRun = Algo::LowerBoundBy(Runs, FirstSlotChangedByReplication, &FElementusItemRun::FirstSlot);
+
+	QueueSlotUpdates(RunsBeforeReplication, Runs.Slice(FirstRun, Runs.Num() - FirstRun), true);
+
+	FirstSlotChangedByReplication = INDEX_NONE;
+	RunsBeforeReplication.Reset();
 }
 
-void UElementusInventoryComponent::UpdateElementusItems(const TArray<FElementusItemInfo>& Modifiers,
-                                                        const EElementusInventoryUpdateOperation Operation)
+void UElementusInventoryComponent::QueueSlotUpdate(const int32 SlotIndex, const EElementusInventorySlotUpdate UpdateType, const FElementusItemInfo& ItemInfo)
 {
-	TArray<FItemModifierData> ModifierDataArr;
-
-	const FString OpStr = Operation == EElementusInventoryUpdateOperation::Add ? "Add" : "Remove";
-	const FString OpPred = Operation == EElementusInventoryUpdateOperation::Add ? "to" : "from";
+	FElementusPendingSlotUpdate& NewUpdate = PendingSlotUpdates.AddDefaulted_GetRef();
+	NewUpdate.SlotIndex = SlotIndex;
+	NewUpdate.UpdateType = UpdateType;
+	NewUpdate.ItemInfo = ItemInfo;
+}
 
-	uint32 SearchOffset = 0;
-	FElementusItemInfo LastCheckedItem;
-	for (const FElementusItemInfo& Iterator : Modifiers)
+void UElementusInventoryComponent::QueueSlotUpdates(const TArrayView<const FElementusItemRun> OldRuns, const TArrayView<const FElementusItemRun> NewRuns,
+                                                    const bool bApplyWeightDeltas)
+{
+	FElementusItemSlots::DiffRuns(OldRuns, NewRuns, [this, bApplyWeightDeltas](const int32 FirstSlot, const int32 NumSlots,
+	                                                                          const FElementusItemInfo* const OldItem,
+	                                                                          const FElementusItemInfo* const NewItem)
 	{
-		UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: %s %d item(s) with name '%s' %s inventory"), *FString(__FUNCTION__), *OpStr,
-		       Iterator.Quantity, *Iterator.ItemId.ToString(), *OpPred);
+		if (OldItem && NewItem && FElementusItemRun::HasSameContent(*OldItem, *NewItem))
+		{
+			return;
+		}
 
-		if (Iterator != LastCheckedItem)
+		// Keep the weight up to date with the slot deltas instead of recomputing it from all items
+		if (bApplyWeightDeltas && OldItem && UElementusInventoryFunctions::IsItemValid(*OldItem))
 		{
-			SearchOffset = 0u;
+			ApplyItemWeightDelta(OldItem->ItemId, -OldItem->Quantity * NumSlots);
 		}
 
-		int32 Index;
-		if (FindFirstItemIndexWithInfo(Iterator, Index, FGameplayTagContainer::EmptyContainer, SearchOffset) && Operation ==
-			EElementusInventoryUpdateOperation::Remove)
+		if (bApplyWeightDeltas && NewItem && UElementusInventoryFunctions::IsItemValid(*NewItem))
 		{
-			SearchOffset = Index + 1u;
+			ApplyItemWeightDelta(NewItem->ItemId, NewItem->Quantity * NumSlots);
 		}
 
-		ModifierDataArr.Add(FItemModifierData(Iterator, Index));
-		LastCheckedItem = Iterator;
-	}
+		const EElementusInventorySlotUpdate UpdateType = !OldItem
+			                                                 ? EElementusInventorySlotUpdate::Added
+			                                                 : !NewItem
+			                                                 ? EElementusInventorySlotUpdate::Removed
+			                                                 : EElementusInventorySlotUpdate::Changed;
 
-	switch (Operation)
+		for (int32 Slot = FirstSlot; Slot < FirstSlot + NumSlots; ++Slot)
+		{
+			QueueSlotUpdate(Slot, UpdateType, NewItem ? *NewItem : *OldItem);
+		}
+	});
+}
+
+void UElementusInventoryComponent::SyncReplicatedItems()
+{
+	ELEMENTUS_INVENTORY_SCOPE(SyncReplicatedItems);
+
+	// bCompactItemRuns may have been changed since the last update
+	ItemSlots.SetCompactRuns(bCompactItemRuns);
+
+	if (ReplicatedItems.SyncFromItems(ItemSlots))
 	{
-	case EElementusInventoryUpdateOperation::Add:
-		Server_ProcessInventoryAddition_Internal(ModifierDataArr);
-		break;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UElementusInventoryComponent, ReplicatedItems, this);
 
-	case EElementusInventoryUpdateOperation::Remove:
-		Server_ProcessInventoryRemoval_Internal(ModifierDataArr);
-		break;
+		if (UElementusInventorySubsystem* const Subsystem = UElementusInventorySubsystem::Get(this))
+		{
+			Subsystem->MarkInventoryDirty(this);
+		}
 
-	default:
-		break;
+		UpdateInventorySummary();
 	}
 }
 
-void UElementusInventoryComponent::Server_ProcessInventoryAddition_Internal_Implementation(const TArray<FItemModifierData>& Modifiers)
+void UElementusInventoryComponent::UpdateInventorySummary()
 {
-	if (GetOwnerRole() != ROLE_Authority)
+	if (!bReplicateItemsToOwnerOnly)
 	{
 		return;
 	}
 
-	for (const FItemModifierData& Iterator : Modifiers)
+	FElementusInventorySummary NewSummary;
+	NewSummary.Weight = CurrentWeight;
+
+	for (const FElementusItemRun& Iterator : ItemSlots.GetRuns())
 	{
-		if (const bool bIsStackable = UElementusInventoryFunctions::IsItemStackable(Iterator.ItemInfo); bIsStackable && Iterator.Index != INDEX_NONE)
+		if (!UElementusInventoryFunctions::IsItemValid(Iterator.ItemInfo))
 		{
-			ElementusItems[Iterator.Index].Quantity += Iterator.ItemInfo.Quantity;
+			continue;
 		}
-		else if (!bIsStackable)
+
+		NewSummary.NumItems += Iterator.RunLength;
+
+		if (!SummaryVisibleTags.IsEmpty() && Iterator.ItemInfo.Tags.HasAny(SummaryVisibleTags))
 		{
-			for (int32 i = 0u; i < Iterator.ItemInfo.Quantity; ++i)
+			for (int32 Slot = 0; Slot < Iterator.RunLength; ++Slot)
 			{
-				const FElementusItemInfo ItemInfo{Iterator.ItemInfo.ItemId, 1, Iterator.ItemInfo.Tags};
-
-				ElementusItems.Add(ItemInfo);
+				NewSummary.VisibleItems.Add(Iterator.ItemInfo);
 			}
 		}
-		else
-		{
-			ElementusItems.Add(Iterator.ItemInfo);
-		}
 	}
 
-	NotifyInventoryChange();
+	if (NewSummary != InventorySummary)
+	{
+		InventorySummary = MoveTemp(NewSummary);
+		MARK_PROPERTY_DIRTY_FROM_NAME(UElementusInventoryComponent, InventorySummary, this);
+	}
 }
 
-void UElementusInventoryComponent::Server_ProcessInventoryRemoval_Internal_Implementation(const TArray<FItemModifierData>& Modifiers)
+void UElementusInventoryComponent::OnRep_InventorySummary()
 {
-	if (GetOwnerRole() != ROLE_Authority)
+	// Only the connections that don't own this inventory receive the summary, and they don't have the items to compute the weight
+	CurrentWeight = InventorySummary.Weight;
+
+	OnInventoryUpdate.Broadcast();
+}
+
+void UElementusInventoryComponent::UpdateMemoryStats()
+{
+#if STATS
+	const int64 NewItemsMemory = ItemSlots.GetAllocatedSize();
+	const int64 NewReplicatedItemsMemory = ReplicatedItems.Entries.GetAllocatedSize();
+
+	ELEMENTUS_INVENTORY_MEMORY_DELTA(ItemsMemory, NewItemsMemory - ReportedItemsMemory);
+	ELEMENTUS_INVENTORY_MEMORY_DELTA(ReplicatedItemsMemory, NewReplicatedItemsMemory - ReportedReplicatedItemsMemory);
+
+	ReportedItemsMemory = NewItemsMemory;
+	ReportedReplicatedItemsMemory = NewReplicatedItemsMemory;
+#endif
+}
+
+void UElementusInventoryComponent::BroadcastPendingSlotUpdates()
+{
+	for (const FElementusPendingSlotUpdate& Iterator : PendingSlotUpdates)
 	{
-		return;
+		OnInventoryItemUpdate.Broadcast(Iterator.SlotIndex, Iterator.ItemInfo, Iterator.UpdateType);
 	}
 
-	for (const FItemModifierData& Iterator : Modifiers)
+	PendingSlotUpdates.Reset();
+}
+
+void UElementusInventoryComponent::OnRep_ElementusItems()
+{
+	ELEMENTUS_INVENTORY_SCOPE(OnRepItems);
+
+	// On clients, the replicated entries were already applied one by one to the runs with the same keys
+	if (GetOwnerRole() != ROLE_Authority)
 	{
-		if (Iterator.Index == INDEX_NONE || Iterator.Index > ElementusItems.Num())
-		{
-			UE_LOG(LogElementusInventory_Internal, Warning, TEXT("%s: Item with name '%s' not found in inventory"), *FString(__FUNCTION__),
-			       *Iterator.ItemInfo.ItemId.ToString());
+		QueueReplicatedSlotUpdates();
+		MarkSlotsDirty();
 
-			continue;
+		if (IsInventoryEmpty())
+		{
+			CurrentWeight = 0.f;
+			CurrentValue = 0.f;
+			OnInventoryEmpty.Broadcast();
 		}
 
-		ElementusItems[Iterator.Index].Quantity -= Iterator.ItemInfo.Quantity;
+		UpdateMemoryStats();
+
+		BroadcastPendingSlotUpdates();
+		OnInventoryUpdate.Broadcast();
+
+		return;
 	}
 
-	if (bAllowEmptySlots)
+	const int32 PreviousNum = ItemSlots.Num();
+
+	// Fixed slots keep their positions and their allocation: only the other inventories drop their trailing empty slots
+	if (HasFixedSlots())
 	{
-		Algo::ForEach(ElementusItems, [](FElementusItemInfo& InInfo)
-		{
-			if (InInfo.Quantity <= 0)
-			{
-				InInfo = FElementusItemInfo::EmptyItemInfo;
-			}
-		});
+		FillFixedSlots();
 	}
 	else
 	{
-		ElementusItems.RemoveAll([](const FElementusItemInfo& InInfo)
+		const TArrayView<const FElementusItemRun> Runs = ItemSlots.GetRuns();
+		const int32 LastValidRun = Runs.FindLastByPredicate([](const FElementusItemRun& Run)
 		{
-			return InInfo.Quantity <= 0;
+			return UElementusInventoryFunctions::IsItemValid(Run.ItemInfo);
 		});
-	}
 
-	NotifyInventoryChange();
-}
+		ItemSlots.SetNum(LastValidRun == INDEX_NONE ? 0 : Runs[LastValidRun].FirstSlot + Runs[LastValidRun].RunLength);
 
-void UElementusInventoryComponent::OnRep_ElementusItems()
-{
-	if (const int32 LastValidIndex = ElementusItems.FindLastByPredicate([](const FElementusItemInfo& Item)
-	{
-		return UElementusInventoryFunctions::IsItemValid(Item);
-	}); LastValidIndex != INDEX_NONE && ElementusItems.IsValidIndex(LastValidIndex + 1))
-	{
-		ElementusItems.RemoveAt(LastValidIndex + 1, ElementusItems.Num() - LastValidIndex - 1, false);
-	}
-	else if (LastValidIndex == INDEX_NONE && !UElementusInventoryFunctions::HasEmptyParam(ElementusItems))
-	{
-		ElementusItems.Empty();
+		// Empty slots are reused by the next additions, so keep the allocation to avoid growing it again
+		if (!bAllowEmptySlots)
+		{
+			ItemSlots.Shrink();
+		}
 	}
 
-	ElementusItems.Shrink();
-
 	if (IsInventoryEmpty())
 	{
-		ElementusItems.Empty();
+		if (!HasFixedSlots())
+		{
+			ItemSlots.Empty();
+		}
 
 		CurrentWeight = 0.f;
+		CurrentValue = 0.f;
 		OnInventoryEmpty.Broadcast();
 	}
-	else
+
+	if (PreviousNum != ItemSlots.Num())
 	{
-		UpdateWeight();
+		MarkSlotsDirty();
 	}
 
+	SyncReplicatedItems();
+	UpdateMemoryStats();
+
+	BroadcastPendingSlotUpdates();
 	OnInventoryUpdate.Broadcast();
 }
 
 void UElementusInventoryComponent::NotifyInventoryChange()
 {
+	if (IsInTransaction())
+	{
+		bHasPendingInventoryChange = true;
+		return;
+	}
+
 	if (GetOwnerRole() == ROLE_Authority)
 	{
+		// Also sends the changed slots to the replicated entries
 		OnRep_ElementusItems();
 	}
-
-	MARK_PROPERTY_DIRTY_FROM_NAME(UElementusInventoryComponent, ElementusItems, this);
 }
 
-void UElementusInventoryComponent::UpdateWeight_Implementation()
+void UElementusInventoryComponent::UpdateWeight()
 {
-	float NewWeight = 0.f;
-	for (const FElementusItemInfo& Iterator : ElementusItems)
-	{
-		if (const UElementusItemData* const ItemData = UElementusInventoryFunctions::GetSingleItemDataById(Iterator.ItemId, {"Data"}))
-		{
-			NewWeight += ItemData->ItemWeight * Iterator.Quantity;
-		}
-	}
-
-	CurrentWeight = FMath::Clamp(NewWeight, 0.f, MAX_FLT);
+	ForceWeightUpdate();
 }
@@ -0,0 +1,205 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "Components/ElementusInventoryIndex.h"
+#include <Algo/BinarySearch.h>
+
+/* Insert a key in a sorted list of order keys. Runs are usually appended, so the last position is checked first */
+static void InsertRunKey(TArray<int64>& Keys, const int64 InKey)
+{
+	if (Keys.IsEmpty() || Keys.Last() < InKey)
+	{
+		Keys.Add(InKey);
+	}
+	else
+	{
+		Keys.Insert(InKey, Algo::LowerBound(Keys, InKey));
+	}
+}
+
+static void RemoveRunKey(TArray<int64>& Keys, const int64 InKey)
+{
+	if (const int32 Position = Algo::BinarySearch(Keys, InKey); Position != INDEX_NONE)
+	{
+		Keys.RemoveAt(Position, 1, false);
+	}
+}
+
+bool FElementusInventoryIndex::IsDirty() const
+{
+	return bIsDirty;
+}
+
+void FElementusInventoryIndex::MarkDirty()
+{
+	bIsDirty = true;
+}
+
+void FElementusInventoryIndex::Rebuild(const FElementusItemSlots& InItems)
+{
+	// Keep the allocated key lists to avoid reallocations on every rebuild
+	for (TPair<FPrimaryAssetId, TArray<int64>>& Iterator : RunsById)
+	{
+		Iterator.Value.Reset();
+	}
+
+	for (TPair<FGameplayTag, TArray<int64>>& Iterator : RunsByTag)
+	{
+		Iterator.Value.Reset();
+	}
+
+	QuantityByKey.Reset();
+	QuantityById.Reset();
+
+	// Runs are in ascending key order, so each key is appended
+	for (const FElementusItemRun& Iterator : InItems.GetRuns())
+	{
+		AddRun(Iterator);
+	}
+
+	bIsDirty = false;
+}
+
+void FElementusInventoryIndex::OnRunAdded(const FElementusItemRun& InRun)
+{
+	if (bIsDirty)
+	{
+		return;
+	}
+
+	AddRun(InRun);
+}
+
+void FElementusInventoryIndex::OnRunRemoved(const FElementusItemRun& InRun)
+{
+	if (bIsDirty)
+	{
+		return;
+	}
+
+	if (TArray<int64>* const Keys = RunsById.Find(InRun.ItemInfo.ItemId))
+	{
+		RemoveRunKey(*Keys, InRun.OrderKey);
+	}
+
+	if (!InRun.ItemInfo.Tags.IsEmpty())
+	{
+		for (const FGameplayTag& Iterator : InRun.ItemInfo.Tags.GetGameplayTagParents())
+		{
+			if (TArray<int64>* const Keys = RunsByTag.Find(Iterator))
+			{
+				RemoveRunKey(*Keys, InRun.OrderKey);
+			}
+		}
+	}
+
+	AddQuantity(InRun.ItemInfo, -InRun.ItemInfo.Quantity * InRun.RunLength);
+}
+
+void FElementusInventoryIndex::OnRunResized(const FElementusItemRun& InRun, const int32 PreviousRunLength)
+{
+	if (bIsDirty)
+	{
+		return;
+	}
+
+	AddQuantity(InRun.ItemInfo, InRun.ItemInfo.Quantity * (InRun.RunLength - PreviousRunLength));
+}
+
+void FElementusInventoryIndex::OnRunsReset()
+{
+	bIsDirty = true;
+}
+
+void FElementusInventoryIndex::AddRun(const FElementusItemRun& InRun)
+{
+	InsertRunKey(RunsById.FindOrAdd(InRun.ItemInfo.ItemId), InRun.OrderKey);
+
+	if (!InRun.ItemInfo.Tags.IsEmpty())
+	{
+		for (const FGameplayTag& Iterator : InRun.ItemInfo.Tags.GetGameplayTagParents())
+		{
+			InsertRunKey(RunsByTag.FindOrAdd(Iterator), InRun.OrderKey);
+		}
+	}
+
+	AddQuantity(InRun.ItemInfo, InRun.ItemInfo.Quantity * InRun.RunLength);
+}
+
+void FElementusInventoryIndex::AddQuantity(const FElementusItemInfo& InItem, const int32 QuantityDelta)
+{
+	if (QuantityDelta == 0)
+	{
+		return;
+	}
+
+	QuantityByKey.FindOrAdd(FElementusItemStackKey(InItem)) += QuantityDelta;
+	QuantityById.FindOrAdd(InItem.ItemId) += QuantityDelta;
+}
+
+const TArray<int64>* FElementusInventoryIndex::FindRunsWithId(const FPrimaryAssetId& InId) const
+{
+	return RunsById.Find(InId);
+}
+
+bool FElementusInventoryIndex::FindRunsWithAllTags(const FGameplayTagContainer& InTags, TArray<int64>& OutRuns) const
+{
+	OutRuns.Reset();
+
+	// Start from the tag with the fewest runs and keep the keys that all the other tags also have
+	TArray<const TArray<int64>*, TInlineAllocator<4>> TagRuns;
+	for (const FGameplayTag& Iterator : InTags)
+	{
+		const TArray<int64>* const Keys = RunsByTag.Find(Iterator);
+		if (!Keys || Keys->IsEmpty())
+		{
+			return false;
+		}
+
+		TagRuns.Add(Keys);
+	}
+
+	if (TagRuns.IsEmpty())
+	{
+		return false;
+	}
+
+	TagRuns.Sort([](const TArray<int64>& A, const TArray<int64>& B)
+	{
+		return A.Num() < B.Num();
+	});
+
+	OutRuns = *TagRuns[0];
+	for (int32 Iterator = 1; Iterator < TagRuns.Num() && !OutRuns.IsEmpty(); ++Iterator)
+	{
+		const TArray<int64>& Keys = *TagRuns[Iterator];
+		OutRuns.RemoveAll([&Keys](const int64 InKey)
+		{
+			return Algo::BinarySearch(Keys, InKey) == INDEX_NONE;
+		});
+	}
+
+	return !OutRuns.IsEmpty();
+}
+
+int32 FElementusInventoryIndex::GetQuantity(const FElementusItemInfo& InItem) const
+{
+	const int32* const Quantity = QuantityByKey.Find(FElementusItemStackKey(InItem));
+	return Quantity ? *Quantity : 0;
+}
+
+int32 FElementusInventoryIndex::GetQuantityWithId(const FPrimaryAssetId& InId) const
+{
+	const int32* const Quantity = QuantityById.Find(InId);
+	return Quantity ? *Quantity : 0;
+}
+
+void FElementusInventoryIndex::Reset()
+{
+	RunsById.Empty();
+	RunsByTag.Empty();
+	QuantityByKey.Empty();
+	QuantityById.Empty();
+	bIsDirty = true;
+}
@@ -0,0 +1,257 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "Components/ElementusInventoryReplication.h"
+#include "Components/ElementusInventoryComponent.h"
+#include <Algo/BinarySearch.h>
+#include <Algo/Unique.h>
+
+#ifdef UE_INLINE_GENERATED_CPP_BY_NAME
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ElementusInventoryReplication)
+#endif
+
+void FElementusReplicatedItem::PreReplicatedRemove(const FElementusReplicatedItemArray& InArraySerializer)
+{
+	if (IsValid(InArraySerializer.Owner))
+	{
+		InArraySerializer.Owner->ApplyReplicatedEntry(*this, EElementusInventorySlotUpdate::Removed);
+	}
+}
+
+void FElementusReplicatedItem::PostReplicatedAdd(const FElementusReplicatedItemArray& InArraySerializer)
+{
+	if (IsValid(InArraySerializer.Owner))
+	{
+		InArraySerializer.Owner->ApplyReplicatedEntry(*this, EElementusInventorySlotUpdate::Added);
+	}
+}
+
+void FElementusReplicatedItem::PostReplicatedChange(const FElementusReplicatedItemArray& InArraySerializer)
+{
+	if (IsValid(InArraySerializer.Owner))
+	{
+		InArraySerializer.Owner->ApplyReplicatedEntry(*this, EElementusInventorySlotUpdate::Changed);
+	}
+}
+
+void FElementusDirtyRuns::OnRunAdded(const FElementusItemRun& InRun)
+{
+	MarkKeyDirty(InRun.OrderKey);
+}
+
+void FElementusDirtyRuns::OnRunRemoved(const FElementusItemRun& InRun)
+{
+	MarkKeyDirty(InRun.OrderKey);
+}
+
+void FElementusDirtyRuns::OnRunResized(const FElementusItemRun& InRun, [[maybe_unused]] const int32 PreviousRunLength)
+{
+	MarkKeyDirty(InRun.OrderKey);
+}
+
+void FElementusDirtyRuns::OnRunsReset()
+{
+	Keys.Reset();
+	bAllRunsDirty = true;
+}
+
+void FElementusDirtyRuns::MarkKeyDirty(const int64 InOrderKey)
+{
+	// Clients never sync the entries, so they never leave this state and don't accumulate keys
+	if (!bAllRunsDirty)
+	{
+		Keys.Add(InOrderKey);
+	}
+}
+
+static int32 FindEntryByKey(const TArray<FElementusReplicatedItem>& Entries, const int64 InOrderKey)
+{
+	return Algo::BinarySearchBy(Entries, InOrderKey, &FElementusReplicatedItem::OrderKey);
+}
+
+bool FElementusReplicatedItemArray::SyncFromItems(const FElementusItemSlots& InItems)
+{
+	if (DirtyRuns.bAllRunsDirty)
+	{
+		DirtyRuns.bAllRunsDirty = false;
+		DirtyRuns.Keys.Reset();
+
+		return SyncAllFromItems(InItems);
+	}
+
+	if (DirtyRuns.Keys.IsEmpty())
+	{
+		return false;
+	}
+
+	TArray<int64>& Keys = DirtyRuns.Keys;
+	Keys.Sort();
+	Keys.SetNum(Algo::Unique(Keys), false);
+
+	const TArrayView<const FElementusItemRun> Runs = InItems.GetRuns();
+
+	// The runs and the entries before the first changed key are the same, so the slots are only compared from there.
+	// After the last changed key, they're compared only if the changed runs moved the next slots
+	if (IsValid(Owner))
+	{
+		const int32 FirstRun = Algo::LowerBoundBy(Runs, Keys[0], &FElementusItemRun::OrderKey);
+		const int32 FirstEntry = Algo::LowerBoundBy(Entries, Keys[0], &FElementusReplicatedItem::OrderKey);
+
+		int32 EndRun = Algo::UpperBoundBy(Runs, Keys.Last(), &FElementusItemRun::OrderKey);
+		int32 EndEntry = Algo::UpperBoundBy(Entries, Keys.Last(), &FElementusReplicatedItem::OrderKey);
+
+		const int32 FirstSlot = Runs.IsValidIndex(FirstRun) ? Runs[FirstRun].FirstSlot : InItems.Num();
+
+		int32 NewEndSlot = FirstSlot;
+		for (int32 Iterator = FirstRun; Iterator < EndRun; ++Iterator)
+		{
+			NewEndSlot += Runs[Iterator].RunLength;
+		}
+
+		int32 OldEndSlot = FirstSlot;
+		for (int32 Iterator = FirstEntry; Iterator < EndEntry; ++Iterator)
+		{
+			OldEndSlot += Entries[Iterator].RunLength;
+		}
+
+		if (OldEndSlot != NewEndSlot)
+		{
+			EndRun = Runs.Num();
+			EndEntry = Entries.Num();
+		}
+
+		TArray<FElementusItemRun> PreviousRuns;
+		PreviousRuns.Reserve(EndEntry - FirstEntry);
+
+		int32 Slot = FirstSlot;
+		for (int32 Iterator = FirstEntry; Iterator < EndEntry; ++Iterator)
+		{
+			FElementusItemRun& PreviousRun = PreviousRuns.Emplace_GetRef(Entries[Iterator].ItemInfo, Entries[Iterator].RunLength);
+			PreviousRun.FirstSlot = Slot;
+
+			Slot += Entries[Iterator].RunLength;
+		}
+
+		Owner->QueueSlotUpdates(PreviousRuns, Runs.Slice(FirstRun, EndRun - FirstRun), false);
+	}
+
+	bool bChanged = false;
+	bool bRemovedEntries = false;
+
+	for (const int64 Iterator : Keys)
+	{
+		const int32 RunIndex = InItems.FindRunIndexByKey(Iterator);
+		const int32 EntryIndex = FindEntryByKey(Entries, Iterator);
+
+		if (RunIndex == INDEX_NONE)
+		{
+			if (EntryIndex != INDEX_NONE)
+			{
+				Entries.RemoveAt(EntryIndex, 1, false);
+				bRemovedEntries = true;
+			}
+
+			continue;
+		}
+
+		const FElementusItemRun& Run = Runs[RunIndex];
+
+		if (EntryIndex == INDEX_NONE)
+		{
+			const int32 NewIndex = Algo::LowerBoundBy(Entries, Iterator, &FElementusReplicatedItem::OrderKey);
+			MarkItemDirty(Entries.Insert_GetRef(FElementusReplicatedItem(Run.ItemInfo, Run.OrderKey, Run.RunLength), NewIndex));
+
+			bChanged = true;
+		}
+		else if (FElementusReplicatedItem& Entry = Entries[EntryIndex]; Entry.RunLength != Run.RunLength || !FElementusItemRun::HasSameContent(
+			Entry.ItemInfo, Run.ItemInfo))
+		{
+			Entry.ItemInfo = Run.ItemInfo;
+			Entry.RunLength = Run.RunLength;
+			MarkItemDirty(Entry);
+
+			bChanged = true;
+		}
+	}
+
+	Keys.Reset();
+
+	if (bRemovedEntries)
+	{
+		MarkArrayDirty();
+		bChanged = true;
+	}
+
+	return bChanged;
+}
+
+bool FElementusReplicatedItemArray::SyncAllFromItems(const FElementusItemSlots& InItems)
+{
+	const TArrayView<const FElementusItemRun> Runs = InItems.GetRuns();
+
+	// The current entries still describe the previous slots: compare them with the new runs to notify each changed slot
+	if (IsValid(Owner))
+	{
+		TArray<FElementusItemRun> PreviousRuns;
+		PreviousRuns.Reserve(Entries.Num());
+
+		int32 Slot = 0;
+		for (const FElementusReplicatedItem& Iterator : Entries)
+		{
+			FElementusItemRun& PreviousRun = PreviousRuns.Emplace_GetRef(Iterator.ItemInfo, Iterator.RunLength);
+			PreviousRun.FirstSlot = Slot;
+
+			Slot += Iterator.RunLength;
+		}
+
+		Owner->QueueSlotUpdates(PreviousRuns, Runs, false);
+	}
+
+	bool bChanged = false;
+	bool bRemovedEntries = false;
+
+	TArray<FElementusReplicatedItem> NewEntries;
+	NewEntries.Reserve(Runs.Num());
+
+	// Entries and runs are both sorted by key on the authority: each entry is matched with the run of the same key,
+	// so resizing or removing a run doesn't touch the entries of the next ones
+	int32 EntryIndex = 0;
+	for (const FElementusItemRun& Run : Runs)
+	{
+		while (Entries.IsValidIndex(EntryIndex) && Entries[EntryIndex].OrderKey < Run.OrderKey)
+		{
+			++EntryIndex;
+			bRemovedEntries = true;
+		}
+
+		if (Entries.IsValidIndex(EntryIndex) && Entries[EntryIndex].OrderKey == Run.OrderKey)
+		{
+			FElementusReplicatedItem& Entry = NewEntries.Add_GetRef(MoveTemp(Entries[EntryIndex++]));
+			if (Entry.RunLength != Run.RunLength || !FElementusItemRun::HasSameContent(Entry.ItemInfo, Run.ItemInfo))
+			{
+				Entry.ItemInfo = Run.ItemInfo;
+				Entry.RunLength = Run.RunLength;
+				MarkItemDirty(Entry);
+
+				bChanged = true;
+			}
+
+			continue;
+		}
+
+		MarkItemDirty(NewEntries.Add_GetRef(FElementusReplicatedItem(Run.ItemInfo, Run.OrderKey, Run.RunLength)));
+		bChanged = true;
+	}
+
+	bRemovedEntries |= EntryIndex < Entries.Num();
+	Entries = MoveTemp(NewEntries);
+
+	if (bRemovedEntries)
+	{
+		MarkArrayDirty();
+		bChanged = true;
+	}
+
+	return bChanged;
+}
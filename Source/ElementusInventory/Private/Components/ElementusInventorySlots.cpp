@@ -0,0 +1,452 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "Components/ElementusInventorySlots.h"
+#include <Algo/BinarySearch.h>
+
+namespace ElementusItemSlots
+{
+	/* Gap left between the keys of appended runs, so runs can be inserted between them without renumbering the others */
+	constexpr int64 OrderKeySpacing = 1ll << 20;
+}
+
+FElementusItemSlots::FElementusItemSlots(const FElementusItemSlots& Other) : Runs(Other.Runs), NumSlots(Other.NumSlots), bCompactRuns(Other.bCompactRuns)
+{
+}
+
+FElementusItemSlots::FElementusItemSlots(FElementusItemSlots&& Other) : Runs(MoveTemp(Other.Runs)), NumSlots(Other.NumSlots),
+                                                                      bCompactRuns(Other.bCompactRuns)
+{
+	Other.Runs.Reset();
+	Other.NumSlots = 0;
+	Other.NotifyRunsReset();
+}
+
+FElementusItemSlots& FElementusItemSlots::operator=(const FElementusItemSlots& Other)
+{
+	if (this != &Other)
+	{
+		Runs = Other.Runs;
+		NumSlots = Other.NumSlots;
+		bCompactRuns = Other.bCompactRuns;
+
+		NotifyRunsReset();
+	}
+
+	return *this;
+}
+
+FElementusItemSlots& FElementusItemSlots::operator=(FElementusItemSlots&& Other)
+{
+	if (this != &Other)
+	{
+		Runs = MoveTemp(Other.Runs);
+		NumSlots = Other.NumSlots;
+		bCompactRuns = Other.bCompactRuns;
+
+		Other.Runs.Reset();
+		Other.NumSlots = 0;
+
+		NotifyRunsReset();
+		Other.NotifyRunsReset();
+	}
+
+	return *this;
+}
+
+void FElementusItemSlots::SetCompactRuns(const bool bInCompactRuns)
+{
+	if (bCompactRuns == bInCompactRuns)
+	{
+		return;
+	}
+
+	bCompactRuns = bInCompactRuns;
+
+	const TArray<FElementusItemRun> PreviousRuns = MoveTemp(Runs);
+	Runs.Reset();
+	NumSlots = 0;
+
+	// The listeners are notified once for the whole rebuild
+	TArray<IElementusItemRunListener*, TInlineAllocator<2>> PreviousListeners = MoveTemp(Listeners);
+	Listeners.Reset();
+
+	for (const FElementusItemRun& Iterator : PreviousRuns)
+	{
+		Add(Iterator.ItemInfo, Iterator.RunLength);
+	}
+
+	Listeners = MoveTemp(PreviousListeners);
+	NotifyRunsReset();
+}
+
+const FElementusItemInfo& FElementusItemSlots::operator[](const int32 Slot) const
+{
+	check(IsValidIndex(Slot));
+
+	return Runs[FindRunIndex(Slot)].ItemInfo;
+}
+
+int32 FElementusItemSlots::FindRunIndex(const int32 Slot) const
+{
+	return Algo::UpperBoundBy(Runs, Slot, &FElementusItemRun::FirstSlot) - 1;
+}
+
+int32 FElementusItemSlots::FindRunIndexByKey(const int64 InOrderKey) const
+{
+	return Algo::BinarySearchBy(Runs, InOrderKey, &FElementusItemRun::OrderKey);
+}
+
+void FElementusItemSlots::SetRange(const int32 FirstSlot, const int32 InNumSlots, const FElementusItemInfo& InItemInfo)
+{
+	check(FirstSlot >= 0 && FirstSlot + InNumSlots <= NumSlots);
+
+	if (InNumSlots <= 0)
+	{
+		return;
+	}
+
+	// Writing the same item in a run would only split and merge it again
+	if (const FElementusItemRun& Run = Runs[FindRunIndex(FirstSlot)]; Run.FirstSlot + Run.RunLength >= FirstSlot + InNumSlots &&
+		FElementusItemRun::HasSameContent(Run.ItemInfo, InItemInfo))
+	{
+		return;
+	}
+
+	const int32 FirstRun = SplitAt(FirstSlot);
+	const int32 EndRun = SplitAt(FirstSlot + InNumSlots);
+
+	if (!bCompactRuns)
+	{
+		// Each slot already has its own run
+		for (int32 Iterator = FirstRun; Iterator < EndRun; ++Iterator)
+		{
+			NotifyRunRemoved(Iterator);
+			Runs[Iterator].ItemInfo = InItemInfo;
+			NotifyRunAdded(Iterator);
+		}
+
+		return;
+	}
+
+	for (int32 Iterator = FirstRun; Iterator < EndRun; ++Iterator)
+	{
+		NotifyRunRemoved(Iterator);
+	}
+
+	// The first run takes all the slots and keeps its key. The first slots don't move
+	Runs[FirstRun].ItemInfo = InItemInfo;
+	Runs[FirstRun].RunLength = InNumSlots;
+	Runs.RemoveAt(FirstRun + 1, EndRun - FirstRun - 1, false);
+
+	NotifyRunAdded(FirstRun);
+	MergeWithNeighbors(FirstRun);
+}
+
+FElementusItemInfo& FElementusItemSlots::GetMutable(const int32 Slot)
+{
+	check(IsValidIndex(Slot));
+
+	const int32 RunIndex = SplitAt(Slot);
+	SplitAt(Slot + 1);
+
+	return Runs[RunIndex].ItemInfo;
+}
+
+int32 FElementusItemSlots::Add(const FElementusItemInfo& InItemInfo, const int32 InNumSlots)
+{
+	const int32 FirstSlot = NumSlots;
+
+	if (InNumSlots <= 0)
+	{
+		return FirstSlot;
+	}
+
+	if (bCompactRuns && !Runs.IsEmpty() && FElementusItemRun::HasSameContent(Runs.Last().ItemInfo, InItemInfo))
+	{
+		const int32 PreviousRunLength = Runs.Last().RunLength;
+		Runs.Last().RunLength += InNumSlots;
+		NumSlots += InNumSlots;
+
+		NotifyRunResized(Runs.Num() - 1, PreviousRunLength);
+
+		return FirstSlot;
+	}
+
+	InsertRuns(Runs.Num(), InItemInfo, InNumSlots);
+
+	return FirstSlot;
+}
+
+void FElementusItemSlots::Append(const TArrayView<const FElementusItemInfo> InItems)
+{
+	for (const FElementusItemInfo& Iterator : InItems)
+	{
+		Add(Iterator);
+	}
+}
+
+void FElementusItemSlots::Append(const FElementusItemSlots& InSlots)
+{
+	for (const FElementusItemRun& Iterator : InSlots.Runs)
+	{
+		Add(Iterator.ItemInfo, Iterator.RunLength);
+	}
+}
+
+void FElementusItemSlots::RemoveAt(const int32 FirstSlot, const int32 InNumSlots)
+{
+	check(FirstSlot >= 0 && FirstSlot + InNumSlots <= NumSlots);
+
+	if (InNumSlots <= 0)
+	{
+		return;
+	}
+
+	// Removing part of a single run only shortens it
+	if (const int32 RunIndex = FindRunIndex(FirstSlot); Runs[RunIndex].RunLength > InNumSlots && Runs[RunIndex].FirstSlot + Runs[RunIndex].RunLength >=
+		FirstSlot + InNumSlots)
+	{
+		Runs[RunIndex].RunLength -= InNumSlots;
+		UpdateFirstSlots(RunIndex + 1);
+
+		NotifyRunResized(RunIndex, Runs[RunIndex].RunLength + InNumSlots);
+
+		return;
+	}
+
+	const int32 FirstRun = SplitAt(FirstSlot);
+	const int32 EndRun = SplitAt(FirstSlot + InNumSlots);
+
+	for (int32 Iterator = FirstRun; Iterator < EndRun; ++Iterator)
+	{
+		NotifyRunRemoved(Iterator);
+	}
+
+	Runs.RemoveAt(FirstRun, EndRun - FirstRun, false);
+
+	// The runs on both sides of the removed slots may now be merged
+	UpdateFirstSlots(FirstRun > 0 ? MergeWithNeighbors(FirstRun - 1) : 0);
+}
+
+int32 FElementusItemSlots::InsertRunWithKey(const int64 InOrderKey, const FElementusItemInfo& InItemInfo, const int32 InRunLength)
+{
+	const int32 RunIndex = Algo::LowerBoundBy(Runs, InOrderKey, &FElementusItemRun::OrderKey);
+	if (Runs.IsValidIndex(RunIndex) && Runs[RunIndex].OrderKey == InOrderKey)
+	{
+		return INDEX_NONE;
+	}
+
+	FElementusItemRun NewRun(InItemInfo, FMath::Max(InRunLength, 0));
+	NewRun.OrderKey = InOrderKey;
+
+	Runs.Insert(MoveTemp(NewRun), RunIndex);
+	UpdateFirstSlots(RunIndex);
+
+	NotifyRunAdded(RunIndex);
+
+	return RunIndex;
+}
+
+void FElementusItemSlots::SetRun(const int32 RunIndex, const FElementusItemInfo& InItemInfo, const int32 InRunLength)
+{
+	check(Runs.IsValidIndex(RunIndex));
+
+	NotifyRunRemoved(RunIndex);
+
+	const bool bResized = Runs[RunIndex].RunLength != InRunLength;
+	Runs[RunIndex].ItemInfo = InItemInfo;
+	Runs[RunIndex].RunLength = FMath::Max(InRunLength, 0);
+
+	if (bResized)
+	{
+		UpdateFirstSlots(RunIndex + 1);
+	}
+
+	NotifyRunAdded(RunIndex);
+}
+
+void FElementusItemSlots::RemoveRun(const int32 RunIndex)
+{
+	check(Runs.IsValidIndex(RunIndex));
+
+	NotifyRunRemoved(RunIndex);
+
+	Runs.RemoveAt(RunIndex, 1, false);
+	UpdateFirstSlots(RunIndex);
+}
+
+void FElementusItemSlots::SetNum(const int32 NewNum)
+{
+	if (NewNum < NumSlots)
+	{
+		RemoveAt(NewNum, NumSlots - NewNum);
+	}
+	else
+	{
+		Add(FElementusItemInfo::EmptyItemInfo, NewNum - NumSlots);
+	}
+}
+
+void FElementusItemSlots::Empty()
+{
+	Runs.Empty();
+	NumSlots = 0;
+
+	NotifyRunsReset();
+}
+
+TArray<FElementusItemInfo> FElementusItemSlots::ToArray() const
+{
+	TArray<FElementusItemInfo> Output;
+	Output.Reserve(NumSlots);
+
+	for (const FElementusItemRun& Iterator : Runs)
+	{
+		for (int32 Slot = 0; Slot < Iterator.RunLength; ++Slot)
+		{
+			Output.Add(Iterator.ItemInfo);
+		}
+	}
+
+	return Output;
+}
+
+SIZE_T FElementusItemSlots::GetAllocatedSize() const
+{
+	return Runs.GetAllocatedSize();
+}
+
+int32 FElementusItemSlots::SplitAt(const int32 Slot)
+{
+	if (Slot >= NumSlots)
+	{
+		return Runs.Num();
+	}
+
+	const int32 RunIndex = FindRunIndex(Slot);
+	if (Runs[RunIndex].FirstSlot == Slot)
+	{
+		return RunIndex;
+	}
+
+	FElementusItemRun NewRun(Runs[RunIndex].ItemInfo, Runs[RunIndex].FirstSlot + Runs[RunIndex].RunLength - Slot);
+	NewRun.FirstSlot = Slot;
+
+	const int32 PreviousRunLength = Runs[RunIndex].RunLength;
+	Runs[RunIndex].RunLength = Slot - Runs[RunIndex].FirstSlot;
+	Runs.Insert(MoveTemp(NewRun), RunIndex + 1);
+
+	AssignOrderKeys(RunIndex + 1, 1);
+
+	NotifyRunResized(RunIndex, PreviousRunLength);
+	NotifyRunAdded(RunIndex + 1);
+
+	return RunIndex + 1;
+}
+
+int32 FElementusItemSlots::MergeWithNeighbors(const int32 RunIndex)
+{
+	if (!bCompactRuns || !Runs.IsValidIndex(RunIndex))
+	{
+		return RunIndex;
+	}
+
+	if (Runs.IsValidIndex(RunIndex + 1) && FElementusItemRun::HasSameContent(Runs[RunIndex].ItemInfo, Runs[RunIndex + 1].ItemInfo))
+	{
+		NotifyRunRemoved(RunIndex + 1);
+
+		const int32 PreviousRunLength = Runs[RunIndex].RunLength;
+		Runs[RunIndex].RunLength += Runs[RunIndex + 1].RunLength;
+		Runs.RemoveAt(RunIndex + 1, 1, false);
+
+		NotifyRunResized(RunIndex, PreviousRunLength);
+	}
+
+	// The previous run keeps its key and first slot
+	if (RunIndex > 0 && FElementusItemRun::HasSameContent(Runs[RunIndex - 1].ItemInfo, Runs[RunIndex].ItemInfo))
+	{
+		NotifyRunRemoved(RunIndex);
+
+		const int32 PreviousRunLength = Runs[RunIndex - 1].RunLength;
+		Runs[RunIndex - 1].RunLength += Runs[RunIndex].RunLength;
+		Runs.RemoveAt(RunIndex, 1, false);
+
+		NotifyRunResized(RunIndex - 1, PreviousRunLength);
+
+		return RunIndex - 1;
+	}
+
+	return RunIndex;
+}
+
+void FElementusItemSlots::InsertRuns(const int32 RunIndex, const FElementusItemInfo& InItemInfo, const int32 InNumSlots)
+{
+	const int32 NumNewRuns = bCompactRuns ? 1 : InNumSlots;
+
+	Runs.InsertDefaulted(RunIndex, NumNewRuns);
+	for (int32 Iterator = RunIndex; Iterator < RunIndex + NumNewRuns; ++Iterator)
+	{
+		Runs[Iterator].ItemInfo = InItemInfo;
+		Runs[Iterator].RunLength = bCompactRuns ? InNumSlots : 1;
+	}
+
+	AssignOrderKeys(RunIndex, NumNewRuns);
+	UpdateFirstSlots(RunIndex);
+
+	for (int32 Iterator = RunIndex; Iterator < RunIndex + NumNewRuns; ++Iterator)
+	{
+		NotifyRunAdded(Iterator);
+	}
+}
+
+void FElementusItemSlots::UpdateFirstSlots(const int32 FromRunIndex)
+{
+	int32 Slot = Runs.IsValidIndex(FromRunIndex - 1) ? Runs[FromRunIndex - 1].FirstSlot + Runs[FromRunIndex - 1].RunLength : 0;
+
+	for (int32 Iterator = FromRunIndex; Iterator < Runs.Num(); ++Iterator)
+	{
+		Runs[Iterator].FirstSlot = Slot;
+		Slot += Runs[Iterator].RunLength;
+	}
+
+	NumSlots = Slot;
+}
+
+void FElementusItemSlots::AssignOrderKeys(const int32 FirstRunIndex, const int32 NumRuns)
+{
+	const int64 PreviousKey = FirstRunIndex > 0 ? Runs[FirstRunIndex - 1].OrderKey : 0;
+	const int64 AppendRange = (NumRuns + 1) * ElementusItemSlots::OrderKeySpacing;
+
+	// Appended runs only run out of keys after about 2^43 runs
+	if (FirstRunIndex + NumRuns >= Runs.Num() && PreviousKey > MAX_int64 - AppendRange)
+	{
+		RenumberOrderKeys();
+		return;
+	}
+
+	const int64 NextKey = FirstRunIndex + NumRuns < Runs.Num() ? Runs[FirstRunIndex + NumRuns].OrderKey : PreviousKey + AppendRange;
+
+	if (const int64 Step = (NextKey - PreviousKey) / (NumRuns + 1); Step >= 1)
+	{
+		for (int32 Iterator = 0; Iterator < NumRuns; ++Iterator)
+		{
+			Runs[FirstRunIndex + Iterator].OrderKey = PreviousKey + Step * (Iterator + 1);
+		}
+
+		return;
+	}
+
+	RenumberOrderKeys();
+}
+
+void FElementusItemSlots::RenumberOrderKeys()
+{
+	for (int32 Iterator = 0; Iterator < Runs.Num(); ++Iterator)
+	{
+		Runs[Iterator].OrderKey = ElementusItemSlots::OrderKeySpacing * (Iterator + 1);
+	}
+
+	NotifyRunsReset();
+}
@@ -0,0 +1,121 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "Components/ElementusInventorySnapshot.h"
+#include "Management/ElementusInventoryCache.h"
+#include "LogElementusInventory.h"
+#include <Serialization/MemoryWriter.h>
+#include <Serialization/MemoryReader.h>
+#include <GameplayTagsManager.h>
+
+namespace ElementusInventorySnapshot
+{
+	constexpr uint8 PortableFlag = 1 << 0;
+}
+
+void FElementusInventorySnapshot::Write(TArray<uint8>& OutData, const FElementusItemSlots& InItems, const float InWeight, const float InValue,
+                                        const bool bPortable)
+{
+	FMemoryWriter Writer(OutData, true);
+	Writer.Seek(OutData.Num());
+
+	uint32 MagicValue = Magic;
+	uint8 Version = static_cast<uint8>(EVersion::Latest);
+	uint8 Flags = bPortable ? ElementusInventorySnapshot::PortableFlag : 0;
+	uint32 TagTableHash = UGameplayTagsManager::Get().GetNetworkGameplayTagNodeIndexHash();
+	uint32 CatalogHash = FElementusItemDefinitionCache::Get().GetCatalogHash();
+	float Weight = InWeight;
+	float Value = InValue;
+	uint32 NumRuns = InItems.GetRuns().Num();
+
+	Writer << MagicValue << Version << Flags << TagTableHash << CatalogHash << Weight << Value;
+	Writer.SerializeIntPacked(NumRuns);
+
+	for (const FElementusItemRun& Iterator : InItems.GetRuns())
+	{
+		uint32 RunLength = Iterator.RunLength;
+		Writer.SerializeIntPacked(RunLength);
+
+		Iterator.ItemInfo.SaveSnapshot(Writer, bPortable);
+	}
+}
+
+bool FElementusInventorySnapshot::Read(const TArray<uint8>& InData, FElementusInventorySnapshotData& OutSnapshot)
+{
+	FMemoryReader Reader(InData, true);
+
+	uint32 MagicValue = 0u;
+	uint8 Version = 0u;
+	uint8 Flags = 0u;
+	uint32 TagTableHash = 0u;
+	uint32 CatalogHash = 0u;
+	uint32 NumRuns = 0u;
+
+	Reader << MagicValue << Version;
+	if (Reader.IsError() || MagicValue != Magic || Version == 0u || Version > static_cast<uint8>(EVersion::Latest))
+	{
+		UE_LOG(LogElementusInventory_Internal, Error, TEXT("%s: Invalid snapshot header or unknown version %u"), *FString(__FUNCTION__), Version);
+		return false;
+	}
+
+	Reader << Flags;
+
+	// The initial version stored a single hash that mixed the tag table with the item catalog
+	if (Version >= static_cast<uint8>(EVersion::SeparateHashes))
+	{
+		Reader << TagTableHash;
+	}
+
+	Reader << CatalogHash << OutSnapshot.Weight << OutSnapshot.Value;
+	Reader.SerializeIntPacked(NumRuns);
+
+	// Each run takes at least two bytes: a larger count can only come from corrupted data
+	if (Reader.IsError() || NumRuns > static_cast<uint32>(InData.Num()))
+	{
+		UE_LOG(LogElementusInventory_Internal, Error, TEXT("%s: Corrupted snapshot header"), *FString(__FUNCTION__));
+		return false;
+	}
+
+	const bool bPortable = (Flags & ElementusInventorySnapshot::PortableFlag) != 0;
+
+	// Tag net indices can only be resolved with the same tag table. Item changes are handled by validating the loaded items
+	const bool bSameTagTable = Version >= static_cast<uint8>(EVersion::SeparateHashes) && TagTableHash == UGameplayTagsManager::Get().
+		GetNetworkGameplayTagNodeIndexHash();
+
+	if (!bSameTagTable && !bPortable)
+	{
+		UE_LOG(LogElementusInventory_Internal, Error, TEXT("%s: The snapshot was saved with a different tag table and stores tag net indices"),
+		       *FString(__FUNCTION__));
+		return false;
+	}
+
+	const uint32 CurrentCatalogHash = FElementusItemDefinitionCache::Get().GetCatalogHash();
+	OutSnapshot.bIsKnownValid = bSameTagTable && CatalogHash != 0u && CatalogHash == CurrentCatalogHash;
+
+	// Previous versions stored one item per slot
+	const bool bHasRuns = Version >= static_cast<uint8>(EVersion::ItemRuns);
+
+	OutSnapshot.Items.Empty();
+	for (uint32 Iterator = 0u; Iterator < NumRuns; ++Iterator)
+	{
+		uint32 RunLength = 1u;
+		if (bHasRuns)
+		{
+			Reader.SerializeIntPacked(RunLength);
+		}
+
+		FElementusItemInfo Item;
+		Item.LoadSnapshot(Reader, bPortable);
+
+		if (Reader.IsError() || RunLength == 0u || RunLength > static_cast<uint32>(MAX_int32 - OutSnapshot.Items.Num()))
+		{
+			UE_LOG(LogElementusInventory_Internal, Error, TEXT("%s: Corrupted snapshot items"), *FString(__FUNCTION__));
+			return false;
+		}
+
+		OutSnapshot.Items.Add(Item, static_cast<int32>(RunLength));
+	}
+
+	return true;
+}
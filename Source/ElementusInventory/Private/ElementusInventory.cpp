@@ -3,14 +3,35 @@
 // Repo: https://github.com/lucoiso/UEElementusInventory
 
 #include "ElementusInventory.h"
+#include "Management/ElementusInventoryCache.h"
+#include "Management/ElementusInventorySettings.h"
+#include "Management/ElementusItemCatalog.h"
+#include <Engine/AssetManager.h>
 #include <Modules/ModuleManager.h>
 
 void FElementusInventoryModule::StartupModule()
 {
+	// The item datas may be edited while the editor is running, so only cooked servers use the catalog
+	if (!GIsEditor && IsRunningDedicatedServer() && UElementusInventorySettings::Get()->bUseCookedItemCatalog)
+	{
+		if (FElementusItemCatalog::Get().Load(UElementusInventorySettings::Get()->GetCookedItemCatalogFilePath()))
+		{
+			FElementusItemDefinitionCache::Get().PreloadAllDefinitions();
+			return;
+		}
+	}
+
+	// The catalog hash only needs the registered item ids, so it's known before any item data is loaded
+	UAssetManager::CallOrRegister_OnCompletedInitialScan(FSimpleMulticastDelegate::FDelegate::CreateLambda([]
+	{
+		FElementusItemDefinitionCache::Get().UpdateCatalogHashFromAssetManager();
+	}));
 }
 
 void FElementusInventoryModule::ShutdownModule()
 {
+	FElementusItemDefinitionCache::Get().Reset();
+	FElementusItemCatalog::Get().Unload();
 }
 
 IMPLEMENT_MODULE(FElementusInventoryModule, ElementusInventory)
@@ -0,0 +1,27 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "ElementusInventoryStats.h"
+
+DEFINE_STAT(STAT_ElementusInventory_AddItems);
+DEFINE_STAT(STAT_ElementusInventory_RemoveItems);
+DEFINE_STAT(STAT_ElementusInventory_ValidateTrade);
+DEFINE_STAT(STAT_ElementusInventory_TradeItems);
+DEFINE_STAT(STAT_ElementusInventory_BulkOperations);
+DEFINE_STAT(STAT_ElementusInventory_Sort);
+DEFINE_STAT(STAT_ElementusInventory_FindItems);
+DEFINE_STAT(STAT_ElementusInventory_ValidateInventory);
+DEFINE_STAT(STAT_ElementusInventory_DefinitionLookup);
+DEFINE_STAT(STAT_ElementusInventory_ItemDataLoad);
+DEFINE_STAT(STAT_ElementusInventory_OnRepItems);
+DEFINE_STAT(STAT_ElementusInventory_SyncReplicatedItems);
+DEFINE_STAT(STAT_ElementusInventory_SnapshotSave);
+DEFINE_STAT(STAT_ElementusInventory_SnapshotLoad);
+DEFINE_STAT(STAT_ElementusInventory_SubsystemFlush);
+
+DEFINE_STAT(STAT_ElementusInventory_ItemsMemory);
+DEFINE_STAT(STAT_ElementusInventory_ReplicatedItemsMemory);
+DEFINE_STAT(STAT_ElementusInventory_ItemPoolsMemory);
+
+UE_TRACE_CHANNEL_DEFINE(ElementusInventoryChannel);
@@ -0,0 +1,73 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "Management/ElementusBundlePolicy.h"
+#include "Management/ElementusInventorySettings.h"
+#include "LogElementusInventory.h"
+#include <Misc/ScopeLock.h>
+
+namespace ElementusBundlePolicy
+{
+	FThreadSafeCounter NumViolations;
+
+	/* Call sites and bundles that were already reported, to log each violation only once */
+	FCriticalSection ReportedViolationsSection;
+	TSet<FString> ReportedViolations;
+}
+
+TArray<FName> FElementusBundlePolicy::FilterBundles(const TArray<FName>& InBundles, const FString& CallSite)
+{
+	const UElementusInventorySettings* const Settings = UElementusInventorySettings::Get();
+	if (!IsRunningDedicatedServer() || Settings->DedicatedServerBundlePolicy == EElementusBundlePolicyMode::Disabled)
+	{
+		return InBundles;
+	}
+
+	TArray<FName> Output;
+	Output.Reserve(InBundles.Num());
+
+	for (const FName& Iterator : InBundles)
+	{
+		if (Settings->DedicatedServerAllowedBundles.Contains(Iterator))
+		{
+			Output.Add(Iterator);
+			continue;
+		}
+
+		ElementusBundlePolicy::NumViolations.Increment();
+
+		const bool bEnforce = Settings->DedicatedServerBundlePolicy == EElementusBundlePolicyMode::Enforce;
+		if (!bEnforce)
+		{
+			Output.Add(Iterator);
+		}
+
+		bool bAlreadyReported;
+		{
+			FScopeLock Lock(&ElementusBundlePolicy::ReportedViolationsSection);
+			ElementusBundlePolicy::ReportedViolations.Add(CallSite + TEXT(":") + Iterator.ToString(), &bAlreadyReported);
+		}
+
+		if (!bAlreadyReported)
+		{
+			UE_LOG(LogElementusInventory, Warning, TEXT("%s: %s requested the bundle %s, which isn't allowed on dedicated servers%s"), *FString(__FUNCTION__),
+			       *CallSite, *Iterator.ToString(), bEnforce ? TEXT(". The bundle was ignored") : TEXT(""));
+		}
+	}
+
+	return Output;
+}
+
+int32 FElementusBundlePolicy::GetNumViolations()
+{
+	return ElementusBundlePolicy::NumViolations.GetValue();
+}
+
+void FElementusBundlePolicy::ResetViolations()
+{
+	ElementusBundlePolicy::NumViolations.Reset();
+
+	FScopeLock Lock(&ElementusBundlePolicy::ReportedViolationsSection);
+	ElementusBundlePolicy::ReportedViolations.Empty();
+}
@@ -0,0 +1,386 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "Management/ElementusInventoryCache.h"
+#include "Management/ElementusInventoryFunctions.h"
+#include "Management/ElementusItemCatalog.h"
+#include "LogElementusInventory.h"
+#include "ElementusInventoryStats.h"
+#include <Engine/AssetManager.h>
+#include <Misc/ScopeRWLock.h>
+
+FElementusItemDefinitionCache& FElementusItemDefinitionCache::Get()
+{
+	static FElementusItemDefinitionCache Instance;
+	return Instance;
+}
+
+bool FElementusItemDefinitionCache::FindDefinition(const FPrimaryAssetId& InItemId, FElementusItemDefinition& OutDefinition)
+{
+	ELEMENTUS_INVENTORY_SCOPE(DefinitionLookup);
+
+	if (FindCachedDefinition(InItemId, OutDefinition))
+	{
+		return true;
+	}
+
+	// Unregistered ids would otherwise retry a synchronous load on every request
+	if (IsMarkedMissing(InItemId))
+	{
+		return false;
+	}
+
+	if (FElementusItemCatalog::Get().FindDefinition(InItemId, OutDefinition))
+	{
+		RegisterDefinition(InItemId, OutDefinition);
+		return true;
+	}
+
+	if (!InItemId.IsValid() || !IsInGameThread())
+	{
+		return false;
+	}
+
+	// The item data registers itself in this cache when loaded by the inventory functions
+	if (const UElementusItemData* const ItemData = UElementusInventoryFunctions::GetSingleItemDataById(FPrimaryElementusItemId(InItemId), {"Data"}))
+	{
+		OutDefinition = ItemData->MakeItemDefinition();
+		return true;
+	}
+
+	MarkMissing(InItemId);
+
+	return false;
+}
+
+bool FElementusItemDefinitionCache::FindDefinition(const FElementusItemHandle& InHandle, FElementusItemDefinition& OutDefinition)
+{
+	if (FindCachedDefinition(InHandle, OutDefinition))
+	{
+		return true;
+	}
+
+	return FindDefinition(ResolveItemHandle(InHandle), OutDefinition);
+}
+
+bool FElementusItemDefinitionCache::FindCachedDefinition(const FPrimaryAssetId& InItemId, FElementusItemDefinition& OutDefinition) const
+{
+	FReadScopeLock Lock(DefinitionsLock);
+
+	if (const FElementusItemHandle* const Handle = HandlesById.Find(InItemId); Handle && CachedDefinitions[Handle->GetIndex()])
+	{
+		OutDefinition = Definitions[Handle->GetIndex()];
+		return true;
+	}
+
+	return false;
+}
+
+bool FElementusItemDefinitionCache::FindCachedDefinition(const FElementusItemHandle& InHandle, FElementusItemDefinition& OutDefinition) const
+{
+	FReadScopeLock Lock(DefinitionsLock);
+
+	if (CachedDefinitions.IsValidIndex(InHandle.GetIndex()) && CachedDefinitions[InHandle.GetIndex()])
+	{
+		OutDefinition = Definitions[InHandle.GetIndex()];
+		return true;
+	}
+
+	return false;
+}
+
+bool FElementusItemDefinitionCache::IsKnownItemId(const FPrimaryAssetId& InItemId) const
+{
+	if (!InItemId.IsValid())
+	{
+		return false;
+	}
+
+	if (FElementusItemDefinition ItemDefinition; FindCachedDefinition(InItemId, ItemDefinition))
+	{
+		return true;
+	}
+
+	if (const FElementusItemCatalog& Catalog = FElementusItemCatalog::Get(); Catalog.IsLoaded())
+	{
+		FElementusItemDefinition ItemDefinition;
+		return Catalog.FindDefinition(InItemId, ItemDefinition);
+	}
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3)
+	const UAssetManager* const AssetManager = UAssetManager::GetIfInitialized();
+#else
+	const UAssetManager* const AssetManager = UAssetManager::GetIfValid();
+#endif
+
+	return AssetManager && AssetManager->GetPrimaryAssetPath(InItemId).IsValid();
+}
+
+FElementusItemHandle FElementusItemDefinitionCache::InternItemId(const FPrimaryAssetId& InItemId)
+{
+	if (!InItemId.IsValid())
+	{
+		return FElementusItemHandle();
+	}
+
+	if (const FElementusItemHandle Handle = FindItemHandle(InItemId); Handle.IsValid())
+	{
+		return Handle;
+	}
+
+	FWriteScopeLock Lock(DefinitionsLock);
+	return InternItemId_Locked(InItemId);
+}
+
+FElementusItemHandle FElementusItemDefinitionCache::InternItemId_Locked(const FPrimaryAssetId& InItemId)
+{
+	// Another thread may have interned the id between the read and the write lock
+	if (const FElementusItemHandle* const Handle = HandlesById.Find(InItemId))
+	{
+		return *Handle;
+	}
+
+	const FElementusItemHandle NewHandle(IdsByHandle.Add(InItemId));
+	HandlesById.Add(InItemId, NewHandle);
+
+	Definitions.AddDefaulted();
+	CachedDefinitions.Add(false);
+	HashedItems.Add(EHashedItem::None);
+
+	return NewHandle;
+}
+
+FElementusItemHandle FElementusItemDefinitionCache::FindItemHandle(const FPrimaryAssetId& InItemId) const
+{
+	FReadScopeLock Lock(DefinitionsLock);
+
+	const FElementusItemHandle* const Handle = HandlesById.Find(InItemId);
+	return Handle ? *Handle : FElementusItemHandle();
+}
+
+FPrimaryAssetId FElementusItemDefinitionCache::ResolveItemHandle(const FElementusItemHandle& InHandle) const
+{
+	FReadScopeLock Lock(DefinitionsLock);
+
+	return IdsByHandle.IsValidIndex(InHandle.GetIndex()) ? IdsByHandle[InHandle.GetIndex()] : FPrimaryAssetId();
+}
+
+void FElementusItemDefinitionCache::PreloadAllDefinitions()
+{
+	if (const FElementusItemCatalog& Catalog = FElementusItemCatalog::Get(); Catalog.IsLoaded())
+	{
+		TArray<FPrimaryAssetId> CatalogIds;
+		CatalogIds.Reserve(Catalog.Num());
+
+		Catalog.ForEachDefinition([this, &CatalogIds](const FPrimaryAssetId& InItemId, const FElementusItemDefinition& InDefinition)
+		{
+			RegisterDefinition(InItemId, InDefinition);
+			CatalogIds.Add(InItemId);
+		});
+
+		UpdateCatalogHash(CatalogIds);
+
+		UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Cached %d item definitions from the item catalog"), *FString(__FUNCTION__),
+		       Catalog.Num());
+		return;
+	}
+
+	const TArray<FPrimaryAssetId> AllIds = UElementusInventoryFunctions::GetAllElementusItemIds();
+	if (UElementusInventoryFunctions::HasEmptyParam(AllIds))
+	{
+		return;
+	}
+
+	TArray<FPrimaryElementusItemId> ItemIds;
+	ItemIds.Reserve(AllIds.Num());
+
+	for (const FPrimaryAssetId& Iterator : AllIds)
+	{
+		ItemIds.Add(FPrimaryElementusItemId(Iterator));
+	}
+
+	const TArray<UElementusItemData*> LoadedData = UElementusInventoryFunctions::GetItemDataArrayById(ItemIds, {"Data"});
+
+	UpdateCatalogHash(AllIds);
+
+	UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Cached %d of %d item definitions"), *FString(__FUNCTION__), LoadedData.Num(),
+	       AllIds.Num());
+}
+
+void FElementusItemDefinitionCache::RegisterItemData(const UElementusItemData* InItemData)
+{
+	if (!IsValid(InItemData))
+	{
+		return;
+	}
+
+	RegisterDefinition(InItemData->GetPrimaryAssetId(), InItemData->MakeItemDefinition());
+}
+
+void FElementusItemDefinitionCache::RegisterDefinition(const FPrimaryAssetId& InItemId, const FElementusItemDefinition& InDefinition)
+{
+	FWriteScopeLock Lock(DefinitionsLock);
+
+	const int32 HandleIndex = InternItemId_Locked(InItemId).GetIndex();
+
+	// A new item or a stackability change makes the hash unknown until it's computed again
+	if (const EHashedItem HashedItem = HashedItems[HandleIndex]; HashedItem == EHashedItem::None || (HashedItem != EHashedItem::UnknownStackability
+		&& (HashedItem == EHashedItem::Stackable) != InDefinition.bIsStackable))
+	{
+		CatalogHash = 0u;
+	}
+
+	Definitions[HandleIndex] = InDefinition;
+	CachedDefinitions[HandleIndex] = true;
+
+	// The ring may still hold the id: it's only removed from the ring when overwritten
+	MissingIds.Remove(InItemId);
+}
+
+void FElementusItemDefinitionCache::Invalidate(const FPrimaryAssetId& InItemId)
+{
+	FWriteScopeLock Lock(DefinitionsLock);
+
+	if (const FElementusItemHandle* const Handle = HandlesById.Find(InItemId))
+	{
+		CachedDefinitions[Handle->GetIndex()] = false;
+	}
+
+	MissingIds.Remove(InItemId);
+}
+
+void FElementusItemDefinitionCache::Reset()
+{
+	FWriteScopeLock Lock(DefinitionsLock);
+
+	// Handles may be held by other systems, so only the definitions are discarded. The item ids and their stackability didn't change, so the hash is kept
+	CachedDefinitions.Init(false, CachedDefinitions.Num());
+	MissingIds.Reset();
+	MissingIdsOrder.Reset();
+	NextMissingId = 0;
+}
+
+int32 FElementusItemDefinitionCache::Num() const
+{
+	FReadScopeLock Lock(DefinitionsLock);
+	return CachedDefinitions.CountSetBits();
+}
+
+uint32 FElementusItemDefinitionCache::GetCatalogHash() const
+{
+	FReadScopeLock Lock(DefinitionsLock);
+	return CatalogHash;
+}
+
+bool FElementusItemDefinitionCache::IsMarkedMissing(const FPrimaryAssetId& InItemId) const
+{
+	FReadScopeLock Lock(DefinitionsLock);
+
+	return MissingIds.Contains(InItemId);
+}
+
+void FElementusItemDefinitionCache::MarkMissing(const FPrimaryAssetId& InItemId)
+{
+	FWriteScopeLock Lock(DefinitionsLock);
+
+	// The definition may have been registered while it was being loaded
+	if (const FElementusItemHandle* const Handle = HandlesById.Find(InItemId); Handle && CachedDefinitions[Handle->GetIndex()])
+	{
+		return;
+	}
+
+	bool bIsAlreadyMissing = false;
+	MissingIds.Add(InItemId, &bIsAlreadyMissing);
+
+	if (bIsAlreadyMissing)
+	{
+		return;
+	}
+
+	if (MissingIdsOrder.Num() < MaxNumMissingIds)
+	{
+		MissingIdsOrder.Add(InItemId);
+		return;
+	}
+
+	// Forget the oldest id. If it was registered and marked again since then, it's forgotten early and only loaded once more
+	if (const FPrimaryAssetId& OldestId = MissingIdsOrder[NextMissingId]; OldestId != InItemId)
+	{
+		MissingIds.Remove(OldestId);
+	}
+
+	MissingIdsOrder[NextMissingId] = InItemId;
+	NextMissingId = (NextMissingId + 1) % MaxNumMissingIds;
+}
+
+void FElementusItemDefinitionCache::UpdateCatalogHashFromAssetManager()
+{
+	const TArray<FPrimaryAssetId> AllIds = UElementusInventoryFunctions::GetAllElementusItemIds();
+	if (UElementusInventoryFunctions::HasEmptyParam(AllIds))
+	{
+		return;
+	}
+
+	UpdateCatalogHash(AllIds);
+
+	UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Computed the catalog hash of %d registered items"), *FString(__FUNCTION__), AllIds.Num());
+}
+
+void FElementusItemDefinitionCache::UpdateCatalogHash(const TArray<FPrimaryAssetId>& InItemIds)
+{
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3)
+	const UAssetManager* const AssetManager = UAssetManager::GetIfInitialized();
+#else
+	const UAssetManager* const AssetManager = UAssetManager::GetIfValid();
+#endif
+
+	// FName indices differ between processes, so the hash is built from the sorted id strings
+	TArray<EHashedItem> HashedStates;
+	HashedStates.Reserve(InItemIds.Num());
+
+	TArray<FString> Entries;
+	Entries.Reserve(InItemIds.Num());
+
+	for (const FPrimaryAssetId& Iterator : InItemIds)
+	{
+		EHashedItem& HashedItem = HashedStates.Add_GetRef(EHashedItem::UnknownStackability);
+
+		FElementusItemDefinition ItemDefinition;
+		FAssetData AssetData;
+		FString StackableTag;
+
+		if (FindCachedDefinition(Iterator, ItemDefinition))
+		{
+			HashedItem = ItemDefinition.bIsStackable ? EHashedItem::Stackable : EHashedItem::NotStackable;
+		}
+		// Items saved before the property was searchable don't have the tag until they're saved again
+		else if (AssetManager && AssetManager->GetPrimaryAssetData(Iterator, AssetData) && AssetData.GetTagValue(
+			GET_MEMBER_NAME_CHECKED(UElementusItemData, bIsStackable), StackableTag))
+		{
+			HashedItem = StackableTag.ToBool() ? EHashedItem::Stackable : EHashedItem::NotStackable;
+		}
+
+		Entries.Add(Iterator.ToString() + (HashedItem == EHashedItem::Stackable ? TEXT("+") : HashedItem == EHashedItem::NotStackable ? TEXT("-") : TEXT("?")));
+	}
+
+	Entries.Sort();
+
+	uint32 NewHash = 0u;
+	for (const FString& Iterator : Entries)
+	{
+		NewHash = FCrc::StrCrc32(*Iterator, NewHash);
+	}
+
+	FWriteScopeLock Lock(DefinitionsLock);
+
+	// The registered ids are bounded, so interning them to remember how they were hashed doesn't grow with the requests
+	HashedItems.Init(EHashedItem::None, HashedItems.Num());
+	for (int32 Iterator = 0; Iterator < InItemIds.Num(); ++Iterator)
+	{
+		HashedItems[InternItemId_Locked(InItemIds[Iterator]).GetIndex()] = HashedStates[Iterator];
+	}
+
+	// Zero means that the hash is unknown
+	CatalogHash = NewHash != 0u ? NewHash : 1u;
+}
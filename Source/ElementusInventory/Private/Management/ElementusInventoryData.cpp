@@ -3,6 +3,10 @@
 // Repo: https://github.com/lucoiso/UEElementusInventory
 
 #include "Management/ElementusInventoryData.h"
+#include "Management/ElementusInventoryCache.h"
+#include <UObject/CoreNet.h>
+#include <Misc/StringBuilder.h>
+#include <GameplayTagsManager.h>
 
 #ifdef UE_INLINE_GENERATED_CPP_BY_NAME
 #include UE_INLINE_GENERATED_CPP_BY_NAME(ElementusInventoryData)
@@ -10,6 +14,294 @@
 
 const FElementusItemInfo FElementusItemInfo::EmptyItemInfo(FPrimaryElementusItemId(), -1);
 
+/* Catalog item names are "Item_<ItemId>", which FName stores as the "Item" base name with <ItemId> as its number */
+static const FName& GetItemBaseName()
+{
+	static const FName ItemBaseName(TEXT("Item"));
+	return ItemBaseName;
+}
+
+static void AppendItemIdString(FStringBuilderBase& Builder, const FPrimaryAssetId& InItemId)
+{
+	// Same string as FPrimaryAssetId::ToString
+	if (InItemId.IsValid())
+	{
+		InItemId.PrimaryAssetType.GetName().AppendString(Builder);
+		Builder << TEXT(':');
+		InItemId.PrimaryAssetName.AppendString(Builder);
+	}
+}
+
+bool FPrimaryElementusItemId::operator<(const FPrimaryElementusItemId& Other) const
+{
+	// Equal ids are the most common case when sorting inventories and only need the integer comparison of the names
+	if (*this == Other)
+	{
+		return false;
+	}
+
+	TStringBuilder<128> ThisString;
+	AppendItemIdString(ThisString, *this);
+
+	TStringBuilder<128> OtherString;
+	AppendItemIdString(OtherString, Other);
+
+	return FCString::Stricmp(*ThisString, *OtherString) < 0;
+}
+
+bool FPrimaryElementusItemId::GetCatalogItemId(uint32& OutItemId) const
+{
+	if (PrimaryAssetType != FPrimaryAssetType(ElementusItemDataType) || PrimaryAssetName.GetComparisonIndex() != GetItemBaseName().GetComparisonIndex() ||
+		PrimaryAssetName.GetNumber() == NAME_NO_NUMBER_INTERNAL)
+	{
+		return false;
+	}
+
+	OutItemId = NAME_INTERNAL_TO_EXTERNAL(PrimaryAssetName.GetNumber());
+	return true;
+}
+
+FPrimaryElementusItemId FPrimaryElementusItemId::MakeCatalogItemId(const uint32 InItemId)
+{
+	return FPrimaryElementusItemId(FPrimaryAssetId(FPrimaryAssetType(ElementusItemDataType), FName(GetItemBaseName(), NAME_EXTERNAL_TO_INTERNAL(InItemId))));
+}
+
+static void SerializeZigZagInt(FArchive& Ar, int32& Value)
+{
+	// Small negative values like the empty item quantity also take a single byte
+	uint32 Encoded = (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	Ar.SerializeIntPacked(Encoded);
+
+	if (Ar.IsLoading())
+	{
+		Value = static_cast<int32>(Encoded >> 1) ^ -static_cast<int32>(Encoded & 1u);
+	}
+}
+
+bool FElementusItemInfo::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 CatalogItemId = 0u;
+	uint8 bIsCatalogId = Ar.IsSaving() && ItemId.GetCatalogItemId(CatalogItemId);
+	uint8 bHasDefaultLevel = Level == 1;
+	uint8 bHasTags = !Tags.IsEmpty();
+
+	Ar.SerializeBits(&bIsCatalogId, 1);
+	Ar.SerializeBits(&bHasDefaultLevel, 1);
+	Ar.SerializeBits(&bHasTags, 1);
+
+	if (bIsCatalogId)
+	{
+		Ar.SerializeIntPacked(CatalogItemId);
+
+		if (Ar.IsLoading())
+		{
+			ItemId = FPrimaryElementusItemId::MakeCatalogItemId(CatalogItemId);
+		}
+	}
+	else
+	{
+		FName TypeName = ItemId.PrimaryAssetType.GetName();
+		UPackageMap::StaticSerializeName(Ar, TypeName);
+		UPackageMap::StaticSerializeName(Ar, ItemId.PrimaryAssetName);
+
+		if (Ar.IsLoading())
+		{
+			ItemId.PrimaryAssetType = FPrimaryAssetType(TypeName);
+		}
+	}
+
+	if (bHasDefaultLevel)
+	{
+		Level = 1;
+	}
+	else
+	{
+		SerializeZigZagInt(Ar, Level);
+	}
+
+	SerializeZigZagInt(Ar, Quantity);
+
+	bOutSuccess = true;
+	if (bHasTags)
+	{
+		Tags.NetSerialize(Ar, Map, bOutSuccess);
+	}
+	else if (Ar.IsLoading())
+	{
+		Tags.Reset();
+	}
+
+	return bOutSuccess && !Ar.IsError();
+}
+
+namespace ElementusItemSnapshot
+{
+	constexpr uint8 CatalogIdFlag = 1 << 0;
+	constexpr uint8 DefaultLevelFlag = 1 << 1;
+	constexpr uint8 HasTagsFlag = 1 << 2;
+}
+
+void FElementusItemInfo::SaveSnapshot(FArchive& Ar, const bool bTagsByName) const
+{
+	check(Ar.IsSaving());
+
+	uint32 CatalogItemId = 0u;
+	uint8 Flags = 0u;
+	Flags |= ItemId.GetCatalogItemId(CatalogItemId) ? ElementusItemSnapshot::CatalogIdFlag : 0;
+	Flags |= Level == 1 ? ElementusItemSnapshot::DefaultLevelFlag : 0;
+	Flags |= Tags.IsEmpty() ? 0 : ElementusItemSnapshot::HasTagsFlag;
+
+	Ar << Flags;
+
+	if (Flags & ElementusItemSnapshot::CatalogIdFlag)
+	{
+		Ar.SerializeIntPacked(CatalogItemId);
+	}
+	else
+	{
+		FName TypeName = ItemId.PrimaryAssetType.GetName();
+		FName AssetName = ItemId.PrimaryAssetName;
+		Ar << TypeName << AssetName;
+	}
+
+	if (!(Flags & ElementusItemSnapshot::DefaultLevelFlag))
+	{
+		int32 LevelValue = Level;
+		SerializeZigZagInt(Ar, LevelValue);
+	}
+
+	int32 QuantityValue = Quantity;
+	SerializeZigZagInt(Ar, QuantityValue);
+
+	if (!(Flags & ElementusItemSnapshot::HasTagsFlag))
+	{
+		return;
+	}
+
+	const UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+
+	uint32 NumTags = Tags.Num();
+	Ar.SerializeIntPacked(NumTags);
+
+	for (const FGameplayTag& Iterator : Tags)
+	{
+		if (bTagsByName)
+		{
+			FName TagName = Iterator.GetTagName();
+			Ar << TagName;
+		}
+		else
+		{
+			uint32 NetIndex = TagsManager.GetNetIndexFromTag(Iterator);
+			Ar.SerializeIntPacked(NetIndex);
+		}
+	}
+}
+
+void FElementusItemInfo::LoadSnapshot(FArchive& Ar, const bool bTagsByName)
+{
+	check(Ar.IsLoading());
+
+	uint8 Flags = 0u;
+	Ar << Flags;
+
+	if (Flags & ElementusItemSnapshot::CatalogIdFlag)
+	{
+		uint32 CatalogItemId = 0u;
+		Ar.SerializeIntPacked(CatalogItemId);
+
+		ItemId = FPrimaryElementusItemId::MakeCatalogItemId(CatalogItemId);
+	}
+	else
+	{
+		FName TypeName;
+		Ar << TypeName << ItemId.PrimaryAssetName;
+
+		ItemId.PrimaryAssetType = FPrimaryAssetType(TypeName);
+	}
+
+	if (Flags & ElementusItemSnapshot::DefaultLevelFlag)
+	{
+		Level = 1;
+	}
+	else
+	{
+		SerializeZigZagInt(Ar, Level);
+	}
+
+	SerializeZigZagInt(Ar, Quantity);
+
+	Tags.Reset();
+
+	if (!(Flags & ElementusItemSnapshot::HasTagsFlag))
+	{
+		return;
+	}
+
+	uint32 NumTags = 0u;
+	Ar.SerializeIntPacked(NumTags);
+
+	// Each tag takes at least one byte: a larger count can only come from corrupted data
+	if (NumTags > static_cast<uint32>(FMath::Max<int64>(Ar.TotalSize() - Ar.Tell(), 0)))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	const UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+
+	for (uint32 Iterator = 0u; Iterator < NumTags && !Ar.IsError(); ++Iterator)
+	{
+		FName TagName;
+		if (bTagsByName)
+		{
+			Ar << TagName;
+		}
+		else
+		{
+			uint32 NetIndex = 0u;
+			Ar.SerializeIntPacked(NetIndex);
+			TagName = TagsManager.GetTagNameFromNetIndex(static_cast<FGameplayTagNetIndex>(NetIndex));
+		}
+
+		// Tags removed since the snapshot was saved are dropped
+		if (const FGameplayTag Tag = FGameplayTag::RequestGameplayTag(TagName, false); Tag.IsValid())
+		{
+			Tags.AddTagFast(Tag);
+		}
+	}
+}
+
 UElementusItemData::UElementusItemData(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 }
+
+FElementusItemDefinition UElementusItemData::MakeItemDefinition() const
+{
+	FElementusItemDefinition Output;
+	Output.ItemId = ItemId;
+	Output.ItemName = ItemName;
+	Output.ItemType = ItemType;
+	Output.bIsStackable = bIsStackable;
+	Output.ItemValue = ItemValue;
+	Output.ItemWeight = ItemWeight;
+
+	return Output;
+}
+
+#if WITH_EDITOR
+void UElementusItemData::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Changing the id also changes the primary asset id, so the old entry can't be found by key anymore
+	if (PropertyChangedEvent.Property && PropertyChangedEvent.Property->GetFName() == GET_MEMBER_NAME_CHECKED(UElementusItemData, ItemId))
+	{
+		FElementusItemDefinitionCache::Get().Reset();
+	}
+	else
+	{
+		FElementusItemDefinitionCache::Get().Invalidate(GetPrimaryAssetId());
+	}
+}
+#endif
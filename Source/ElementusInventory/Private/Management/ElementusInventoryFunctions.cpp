@@ -5,9 +5,13 @@
 #include "Management/ElementusInventoryFunctions.h"
 #include <Components/ElementusInventoryComponent.h>
 #include "Management/ElementusInventoryData.h"
+#include "Management/ElementusInventoryCache.h"
+#include "Management/ElementusItemCatalog.h"
+#include "Management/ElementusBundlePolicy.h"
 #include "LogElementusInventory.h"
+#include "ElementusInventoryStats.h"
 #include <Engine/AssetManager.h>
-#include <Algo/Copy.h>
+#include <Async/ParallelFor.h>
 
 #ifdef UE_INLINE_GENERATED_CPP_BY_NAME
 #include UE_INLINE_GENERATED_CPP_BY_NAME(ElementusInventoryFunctions)
@@ -50,6 +54,8 @@ bool UElementusInventoryFunctions::CompareItemData(const UElementusItemData* Dat
 UElementusItemData* UElementusInventoryFunctions::GetSingleItemDataById(const FPrimaryElementusItemId& InID, const TArray<FName>& InBundles,
                                                                         const bool bAutoUnload)
 {
+	ELEMENTUS_INVENTORY_SCOPE(ItemDataLoad);
+
 	UElementusItemData* Output = nullptr;
 
 #if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3)
@@ -58,7 +64,8 @@ UElementusItemData* UElementusInventoryFunctions::GetSingleItemDataById(const FP
     if (UAssetManager* const AssetManager = UAssetManager::GetIfValid())
 #endif
 	{
-		if (const TSharedPtr<FStreamableHandle> StreamableHandle = AssetManager->LoadPrimaryAsset(InID, InBundles); StreamableHandle.IsValid())
+		const TArray<FName> Bundles = FElementusBundlePolicy::FilterBundles(InBundles, FString(__FUNCTION__));
+		if (const TSharedPtr<FStreamableHandle> StreamableHandle = AssetManager->LoadPrimaryAsset(InID, Bundles); StreamableHandle.IsValid())
 		{
 			StreamableHandle->WaitUntilComplete(5.f);
 			Output = Cast<UElementusItemData>(StreamableHandle->GetLoadedAsset());
@@ -68,6 +75,8 @@ UElementusItemData* UElementusInventoryFunctions::GetSingleItemDataById(const FP
 			Output = AssetManager->GetPrimaryAssetObject<UElementusItemData>(InID);
 		}
 
+		FElementusItemDefinitionCache::Get().RegisterItemData(Output);
+
 		if (bAutoUnload)
 		{
 			AssetManager->UnloadPrimaryAsset(InID);
@@ -80,6 +89,8 @@ UElementusItemData* UElementusInventoryFunctions::GetSingleItemDataById(const FP
 TArray<UElementusItemData*> UElementusInventoryFunctions::GetItemDataArrayById(const TArray<FPrimaryElementusItemId>& InIDs,
                                                                                const TArray<FName>& InBundles, const bool bAutoUnload)
 {
+	ELEMENTUS_INVENTORY_SCOPE(ItemDataLoad);
+
 	TArray<UElementusItemData*> Output;
 
 #if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3)
@@ -88,7 +99,8 @@ TArray<UElementusItemData*> UElementusInventoryFunctions::GetItemDataArrayById(c
     if (UAssetManager* const AssetManager = UAssetManager::GetIfValid())
 #endif
 	{
-		Output = LoadElementusItemDatas_Internal(AssetManager, InIDs, InBundles, bAutoUnload);
+		const TArray<FName> Bundles = FElementusBundlePolicy::FilterBundles(InBundles, FString(__FUNCTION__));
+		Output = LoadElementusItemDatas_Internal(AssetManager, InIDs, Bundles, bAutoUnload);
 	}
 	return Output;
 }
@@ -96,6 +108,8 @@ TArray<UElementusItemData*> UElementusInventoryFunctions::GetItemDataArrayById(c
 TArray<UElementusItemData*> UElementusInventoryFunctions::SearchElementusItemData(const EElementusSearchType SearchType, const FString& SearchString,
                                                                                   const TArray<FName>& InBundles, const bool bAutoUnload)
 {
+	ELEMENTUS_INVENTORY_SCOPE(ItemDataLoad);
+
 	TArray<UElementusItemData*> Output;
 
 #if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3)
@@ -104,43 +118,167 @@ TArray<UElementusItemData*> UElementusInventoryFunctions::SearchElementusItemDat
     if (UAssetManager* const AssetManager = UAssetManager::GetIfValid())
 #endif
 	{
-		TArray<UElementusItemData*> ReturnedValues = LoadElementusItemDatas_Internal(AssetManager, GetAllElementusItemIds(), InBundles, bAutoUnload);
+		const TArray<FName> Bundles = FElementusBundlePolicy::FilterBundles(InBundles, FString(__FUNCTION__));
+		TArray<UElementusItemData*> ReturnedValues = LoadElementusItemDatas_Internal(AssetManager, GetAllElementusItemIds(), Bundles, bAutoUnload);
 
 		for (UElementusItemData* const& Iterator : ReturnedValues)
 		{
-			UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Filtering items. Current iteration: id %s and name %s"), *FString(__FUNCTION__),
-			       *FString::FromInt(Iterator->ItemId), *Iterator->ItemName.ToString());
-
-			bool bAddItem = false;
-			switch (SearchType)
+			if (MatchesSearch(Iterator, SearchType, SearchString))
 			{
-			case EElementusSearchType::Name:
-				bAddItem = Iterator->ItemName.ToString().Contains(SearchString, ESearchCase::IgnoreCase);
-				break;
+				Output.Add(Iterator);
+			}
+		}
+	}
 
-			case EElementusSearchType::ID:
-				bAddItem = FString::FromInt(Iterator->ItemId).Contains(SearchString, ESearchCase::IgnoreCase);
-				break;
+	return Output;
+}
 
-			case EElementusSearchType::Type:
-				bAddItem = ElementusItemEnumTypeToString(Iterator->ItemType).Contains(SearchString, ESearchCase::IgnoreCase);
-				break;
+bool UElementusInventoryFunctions::MatchesSearch(const UElementusItemData* InItemData, const EElementusSearchType SearchType, const FString& SearchString)
+{
+	UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Filtering items. Current iteration: id %s and name %s"), *FString(__FUNCTION__),
+	       *FString::FromInt(InItemData->ItemId), *InItemData->ItemName.ToString());
 
-			default:
-				break;
-			}
+	bool bAddItem = false;
+	switch (SearchType)
+	{
+	case EElementusSearchType::Name:
+		bAddItem = InItemData->ItemName.ToString().Contains(SearchString, ESearchCase::IgnoreCase);
+		break;
 
-			if (bAddItem)
-			{
-				UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Item with id %s and name %s matches the search parameters"),
-				       *FString(__FUNCTION__), *FString::FromInt(Iterator->ItemId), *Iterator->ItemName.ToString());
+	case EElementusSearchType::ID:
+		bAddItem = FString::FromInt(InItemData->ItemId).Contains(SearchString, ESearchCase::IgnoreCase);
+		break;
 
-				Output.Add(Iterator);
+	case EElementusSearchType::Type:
+		bAddItem = ElementusItemEnumTypeToString(InItemData->ItemType).Contains(SearchString, ESearchCase::IgnoreCase);
+		break;
+
+	default:
+		break;
+	}
+
+	if (bAddItem)
+	{
+		UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Item with id %s and name %s matches the search parameters"), *FString(__FUNCTION__),
+		       *FString::FromInt(InItemData->ItemId), *InItemData->ItemName.ToString());
+	}
+
+	return bAddItem;
+}
+
+TSharedPtr<FStreamableHandle> UElementusInventoryFunctions::LoadItemDataArrayAsync(const TArray<FPrimaryElementusItemId>& InIDs,
+                                                                                    const TArray<FName>& InBundles, FElementusItemDataArrayLoaded OnLoaded)
+{
+	const TArray<FName> Bundles = FElementusBundlePolicy::FilterBundles(InBundles, FString(__FUNCTION__));
+	return LoadElementusItemDatasAsync_Internal(TArray<FPrimaryAssetId>(InIDs), Bundles,
+	                                            [OnLoaded = MoveTemp(OnLoaded)](TArray<UElementusItemData*>&& ItemDatas)
+	                                            {
+		                                            OnLoaded.ExecuteIfBound(ItemDatas);
+	                                            });
+}
+
+TSharedPtr<FStreamableHandle> UElementusInventoryFunctions::SearchElementusItemDataAsync(const EElementusSearchType SearchType, const FString& SearchString,
+                                                                                         const TArray<FName>& InBundles,
+                                                                                         FElementusItemDataArrayLoaded OnLoaded)
+{
+	const TArray<FName> Bundles = FElementusBundlePolicy::FilterBundles(InBundles, FString(__FUNCTION__));
+	return LoadElementusItemDatasAsync_Internal(GetAllElementusItemIds(), Bundles,
+	                                            [SearchType, SearchString, OnLoaded = MoveTemp(OnLoaded)](TArray<UElementusItemData*>&& ItemDatas)
+	                                            {
+		                                            ItemDatas.RemoveAll([&SearchType, &SearchString](const UElementusItemData* const Iterator)
+		                                            {
+			                                            return !MatchesSearch(Iterator, SearchType, SearchString);
+		                                            });
+
+		                                            OnLoaded.ExecuteIfBound(ItemDatas);
+	                                            });
+}
+
+TSharedPtr<FStreamableHandle> UElementusInventoryFunctions::LoadElementusItemDatasAsync_Internal(const TArray<FPrimaryAssetId>& InIDs,
+                                                                                                  const TArray<FName>& InBundles,
+                                                                                                  TFunction<void(TArray<UElementusItemData*>&&)>&& OnLoaded)
+{
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3)
+	UAssetManager* const AssetManager = UAssetManager::GetIfInitialized();
+#else
+    UAssetManager* const AssetManager = UAssetManager::GetIfValid();
+#endif
+
+	if (!AssetManager || HasEmptyParam(InIDs))
+	{
+		OnLoaded(TArray<UElementusItemData*>());
+		return nullptr;
+	}
+
+	// The Asset Manager may call the delegate right away if there's nothing to load, or not at all
+	const TSharedRef<bool> bCompleted = MakeShared<bool>(false);
+	const auto OnCompleted_Lambda = [AssetManager, InIDs, bCompleted, OnLoaded = MoveTemp(OnLoaded), FuncName = __func__]
+	{
+		if (*bCompleted)
+		{
+			return;
+		}
+
+		*bCompleted = true;
+
+		TArray<UElementusItemData*> ItemDatas;
+		ItemDatas.Reserve(InIDs.Num());
+
+		for (const FPrimaryAssetId& Iterator : InIDs)
+		{
+			if (UElementusItemData* const ItemData = AssetManager->GetPrimaryAssetObject<UElementusItemData>(Iterator))
+			{
+				FElementusItemDefinitionCache::Get().RegisterItemData(ItemData);
+				ItemDatas.Add(ItemData);
 			}
 		}
+
+		UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Loaded %d of %d item datas asynchronously"), *FString(FuncName), ItemDatas.Num(),
+		       InIDs.Num());
+
+		OnLoaded(MoveTemp(ItemDatas));
+	};
+
+	const FStreamableDelegate Delegate = FStreamableDelegate::CreateLambda(OnCompleted_Lambda);
+	TSharedPtr<FStreamableHandle> StreamableHandle = AssetManager->LoadPrimaryAssets(InIDs, InBundles, Delegate);
+
+	if (!StreamableHandle.IsValid())
+	{
+		// Objects already loaded
+		Delegate.Execute();
 	}
 
-	return Output;
+	return StreamableHandle;
+}
+
+bool UElementusInventoryFunctions::GetItemDefinitionById(const FPrimaryElementusItemId& InID, FElementusItemDefinition& OutDefinition)
+{
+	return FElementusItemDefinitionCache::Get().FindDefinition(InID, OutDefinition);
+}
+
+void UElementusInventoryFunctions::PreloadItemDefinitions()
+{
+	FElementusItemDefinitionCache::Get().PreloadAllDefinitions();
+}
+
+int32 UElementusInventoryFunctions::GetNumBundlePolicyViolations()
+{
+	return FElementusBundlePolicy::GetNumViolations();
+}
+
+void UElementusInventoryFunctions::ResetItemDefinitionCache()
+{
+	FElementusItemDefinitionCache::Get().Reset();
+}
+
+FElementusItemHandle UElementusInventoryFunctions::GetItemHandleById(const FPrimaryElementusItemId& InID)
+{
+	return FElementusItemDefinitionCache::Get().InternItemId(InID);
+}
+
+FPrimaryElementusItemId UElementusInventoryFunctions::GetItemIdByHandle(const FElementusItemHandle& InHandle)
+{
+	return FPrimaryElementusItemId(FElementusItemDefinitionCache::Get().ResolveItemHandle(InHandle));
 }
 
 TMap<FGameplayTag, FName> UElementusInventoryFunctions::GetItemMetadatas(const FElementusItemInfo& InItemInfo)
@@ -158,6 +296,11 @@ TMap<FGameplayTag, FName> UElementusInventoryFunctions::GetItemMetadatas(const F
 TMap<FGameplayTag, FPrimaryElementusItemIdContainer> UElementusInventoryFunctions::GetItemRelations(const FElementusItemInfo& InItemInfo)
 {
 	TMap<FGameplayTag, FPrimaryElementusItemIdContainer> Output;
+	if (FElementusItemCatalog::Get().FindRelations(InItemInfo.ItemId, Output))
+	{
+		return Output;
+	}
+
 	if (const UElementusItemData* const Data = GetSingleItemDataById(InItemInfo.ItemId, TArray<FName>{"Custom"}))
 	{
 		Output = Data->Relations;
@@ -203,6 +346,7 @@ TArray<UElementusItemData*> UElementusInventoryFunctions::LoadElementusItemDatas
 
 			if (UElementusItemData* const CastedAsset = Cast<UElementusItemData>(Iterator))
 			{
+				FElementusItemDefinitionCache::Get().RegisterItemData(CastedAsset);
 				Output.Add(CastedAsset);
 			}
 		}
@@ -258,33 +402,452 @@ TArray<FElementusItemInfo> UElementusInventoryFunctions::FilterTradeableItems(UE
                                                                               const TArray<FElementusItemInfo>& Items)
 {
 	TArray<FElementusItemInfo> Output;
-	float VirtualWeight = ToInventory->GetCurrentWeight();
 
-	Algo::CopyIf(Items, Output, [&](const FElementusItemInfo& Iterator)
+	if (TArray<EElementusTradeItemResult> Results; ValidateTrade(FromInventory, ToInventory, Items, Results) > 0)
+	{
+		for (int32 Iterator = 0; Iterator < Items.Num(); ++Iterator)
+		{
+			if (Results[Iterator] == EElementusTradeItemResult::Accepted)
+			{
+				Output.Add(Items[Iterator]);
+			}
+		}
+	}
+
+	return Output;
+}
+
+/**
+ * Slots of an inventory after the changes validated so far, following the same rules as UpdateElementusItems: removals take the quantity
+ * from all matching slots in order and free the emptied ones, stackable additions go to the first matching slot or to a new one,
+ * and non-stackable additions use a new slot per unit
+ */
+class FElementusVirtualInventory
+{
+public:
+	/* Read the slots of each item from the inventory index when first needed. Game thread only */
+	explicit FElementusVirtualInventory(const UElementusInventoryComponent* InInventory) : Inventory(InInventory), bLoadSlotsOnDemand(true)
+	{
+		Weight = Inventory->GetCurrentWeight();
+		NumAvailableSlots = Inventory->GetNumAvailableSlots();
+	}
+
+	/* Read all slots at once. Only reads the items, so it's safe outside of the game thread while the inventory isn't modified */
+	static FElementusVirtualInventory FromAllItems(const UElementusInventoryComponent* InInventory)
+	{
+		FElementusVirtualInventory Output(InInventory);
+		Output.bLoadSlotsOnDemand = false;
+
+		for (const FElementusItemInfo& Iterator : InInventory->GetItemsView())
+		{
+			if (UElementusInventoryFunctions::IsItemValid(Iterator))
+			{
+				Output.SlotQuantities.FindOrAdd(FElementusItemStackKey(Iterator)).Add(Iterator.Quantity);
+			}
+		}
+
+		return Output;
+	}
+
+	int32 GetQuantity(const FElementusItemInfo& InItem)
+	{
+		int32 Output = 0;
+		for (const int32 Iterator : FindOrLoadSlots(InItem))
+		{
+			Output += Iterator;
+		}
+
+		return Output;
+	}
+
+	int32 GetRequiredSlots(const FElementusItemInfo& InItem, const bool bIsStackable)
+	{
+		if (bIsStackable)
+		{
+			return UElementusInventoryFunctions::HasEmptyParam(FindOrLoadSlots(InItem)) ? 1 : 0;
+		}
+
+		return InItem.Quantity;
+	}
+
+	int32 GetNumAvailableSlots() const
+	{
+		return NumAvailableSlots;
+	}
+
+	float GetWeight() const
+	{
+		return Weight;
+	}
+
+	void AddItem(const FElementusItemInfo& InItem, const FElementusItemDefinition& InDefinition)
+	{
+		TArray<int32>& Slots = FindOrLoadSlots(InItem);
+		const int32 RequiredSlots = GetRequiredSlots(InItem, InDefinition.bIsStackable);
+
+		if (!InDefinition.bIsStackable)
+		{
+			Slots.Reserve(Slots.Num() + InItem.Quantity);
+			for (int32 Iterator = 0; Iterator < InItem.Quantity; ++Iterator)
+			{
+				Slots.Add(1);
+			}
+		}
+		else if (RequiredSlots == 0)
+		{
+			Slots[0] += InItem.Quantity;
+		}
+		else
+		{
+			Slots.Add(InItem.Quantity);
+		}
+
+		Weight += InDefinition.ItemWeight * InItem.Quantity;
+		UpdateAvailableSlots(-RequiredSlots);
+	}
+
+	void RemoveItem(const FElementusItemInfo& InItem, const FElementusItemDefinition& InDefinition)
+	{
+		TArray<int32>& Slots = FindOrLoadSlots(InItem);
+
+		int32 RemainingQuantity = InItem.Quantity;
+		int32 NumFreedSlots = 0;
+
+		for (int32& Iterator : Slots)
+		{
+			const int32 RemovedQuantity = FMath::Min(Iterator, RemainingQuantity);
+			Iterator -= RemovedQuantity;
+			RemainingQuantity -= RemovedQuantity;
+
+			Weight = FMath::Max(Weight - InDefinition.ItemWeight * RemovedQuantity, 0.f);
+			NumFreedSlots += Iterator <= 0 && RemovedQuantity > 0 ? 1 : 0;
+
+			if (RemainingQuantity <= 0)
+			{
+				break;
+			}
+		}
+
+		Slots.RemoveAll([](const int32 Quantity)
+		{
+			return Quantity <= 0;
+		});
+
+		UpdateAvailableSlots(NumFreedSlots);
+	}
+
+	void Clear()
 	{
-		if (VirtualWeight >= ToInventory->GetMaxWeight())
+		SlotQuantities.Reset();
+		bLoadSlotsOnDemand = false;
+
+		Weight = 0.f;
+		NumAvailableSlots = Inventory->GetMaxNumItems();
+	}
+
+private:
+	TArray<int32>& FindOrLoadSlots(const FElementusItemInfo& InItem)
+	{
+		const FElementusItemStackKey ItemKey(InItem);
+		if (TArray<int32>* const Slots = SlotQuantities.Find(ItemKey))
 		{
-			return false;
+			return *Slots;
 		}
 
-		bool bCanTradeIterator = FromInventory->CanGiveItem(Iterator) && ToInventory->CanReceiveItem(Iterator);
+		TArray<int32>& Slots = SlotQuantities.Add(ItemKey);
 
-		if (bCanTradeIterator)
+		if (TArray<int32> Indexes; bLoadSlotsOnDemand && Inventory->FindAllItemIndexesWithInfo(InItem, Indexes, FGameplayTagContainer::EmptyContainer))
 		{
-			if (const UElementusItemData* const ItemData = GetSingleItemDataById(Iterator.ItemId, {"Data"}))
+			const FElementusItemSlots& Items = Inventory->GetItemsView();
+			for (const int32 Iterator : Indexes)
 			{
-				VirtualWeight += Iterator.Quantity * ItemData->ItemWeight;
-				bCanTradeIterator = bCanTradeIterator && VirtualWeight <= ToInventory->GetMaxWeight();
+				if (Items[Iterator].Quantity > 0)
+				{
+					Slots.Add(Items[Iterator].Quantity);
+				}
+			}
+		}
+
+		return Slots;
+	}
+
+	void UpdateAvailableSlots(const int32 Delta)
+	{
+		// Inventories without a limit report MAX_int32 available slots
+		if (Inventory->GetMaxNumItems() != MAX_int32)
+		{
+			NumAvailableSlots = FMath::Max(NumAvailableSlots + Delta, 0);
+		}
+	}
+
+	const UElementusInventoryComponent* Inventory;
+	bool bLoadSlotsOnDemand;
+
+	/* Quantity of each used slot of an item, in slot order */
+	TMap<FElementusItemStackKey, TArray<int32>> SlotQuantities;
+
+	float Weight = 0.f;
+	int32 NumAvailableSlots = 0;
+};
+
+int32 UElementusInventoryFunctions::ValidateTrade(UElementusInventoryComponent* FromInventory, UElementusInventoryComponent* ToInventory,
+                                                  const TArray<FElementusItemInfo>& Items, TArray<EElementusTradeItemResult>& OutResults)
+{
+	ELEMENTUS_INVENTORY_SCOPE(ValidateTrade);
+
+	OutResults.Init(EElementusTradeItemResult::InvalidItem, Items.Num());
+
+	if (!IsValid(FromInventory) || !IsValid(ToInventory) || FromInventory == ToInventory)
+	{
+		return 0;
+	}
+
+	// Virtual state of both inventories after the items accepted so far
+	FElementusVirtualInventory VirtualFromInventory(FromInventory);
+	FElementusVirtualInventory VirtualToInventory(ToInventory);
+
+	int32 NumAccepted = 0;
+	for (int32 Iterator = 0; Iterator < Items.Num(); ++Iterator)
+	{
+		const FElementusItemInfo& Item = Items[Iterator];
+		EElementusTradeItemResult& Result = OutResults[Iterator];
+
+		if (!IsItemValid(Item))
+		{
+			Result = EElementusTradeItemResult::InvalidItem;
+			continue;
+		}
+
+		FElementusItemDefinition ItemDefinition;
+		if (!FElementusItemDefinitionCache::Get().FindDefinition(Item.ItemId, ItemDefinition))
+		{
+			Result = EElementusTradeItemResult::MissingDefinition;
+			continue;
+		}
+
+		if (VirtualFromInventory.GetQuantity(Item) < Item.Quantity)
+		{
+			Result = EElementusTradeItemResult::NotEnoughQuantity;
+			continue;
+		}
+
+		if (VirtualToInventory.GetRequiredSlots(Item, ItemDefinition.bIsStackable) > VirtualToInventory.GetNumAvailableSlots())
+		{
+			Result = EElementusTradeItemResult::NotEnoughSlots;
+			continue;
+		}
+
+		if (VirtualToInventory.GetWeight() + ItemDefinition.ItemWeight * Item.Quantity > ToInventory->GetMaxWeight())
+		{
+			Result = EElementusTradeItemResult::ExceedsMaxWeight;
+			continue;
+		}
+
+		VirtualFromInventory.RemoveItem(Item, ItemDefinition);
+		VirtualToInventory.AddItem(Item, ItemDefinition);
+
+		Result = EElementusTradeItemResult::Accepted;
+		++NumAccepted;
+	}
+
+	return NumAccepted;
+}
+
+bool UElementusInventoryFunctions::TradeItems(UElementusInventoryComponent* FromInventory, UElementusInventoryComponent* ToInventory,
+                                              const TArray<FElementusItemInfo>& Items, TArray<EElementusTradeItemResult>& OutResults,
+                                              const bool bRequireAllItems)
+{
+	ELEMENTUS_INVENTORY_SCOPE(TradeItems);
+
+	const int32 NumAccepted = ValidateTrade(FromInventory, ToInventory, Items, OutResults);
+	if (NumAccepted == 0)
+	{
+		return false;
+	}
+
+	if (FromInventory->GetOwnerRole() != ROLE_Authority || ToInventory->GetOwnerRole() != ROLE_Authority)
+	{
+		UE_LOG(LogElementusInventory, Warning, TEXT("%s: Trades can only be made by the authority"), *FString(__FUNCTION__));
+		return false;
+	}
+
+	if (bRequireAllItems && NumAccepted != Items.Num())
+	{
+		for (EElementusTradeItemResult& Iterator : OutResults)
+		{
+			if (Iterator == EElementusTradeItemResult::Accepted)
+			{
+				Iterator = EElementusTradeItemResult::Cancelled;
+			}
+		}
+
+		return false;
+	}
+
+	TArray<FElementusItemInfo> AcceptedItems;
+	AcceptedItems.Reserve(NumAccepted);
+
+	for (int32 Iterator = 0; Iterator < Items.Num(); ++Iterator)
+	{
+		if (OutResults[Iterator] == EElementusTradeItemResult::Accepted)
+		{
+			AcceptedItems.Add(Items[Iterator]);
+		}
+		else
+		{
+			UE_LOG(LogElementusInventory, Warning, TEXT("%s: Item with name '%s' was rejected from the trade between %s and %s: %s"), *FString(__FUNCTION__),
+			       *Items[Iterator].ItemId.ToString(), *FromInventory->GetOwner()->GetName(), *ToInventory->GetOwner()->GetName(),
+			       *UEnum::GetValueAsString(OutResults[Iterator]));
+		}
+	}
+
+	// Both sides were validated beforehand, so each one is updated and notified only once
+	FElementusInventoryScopedTransaction FromTransaction(FromInventory);
+	FElementusInventoryScopedTransaction ToTransaction(ToInventory);
+
+	FromInventory->UpdateElementusItems(AcceptedItems, EElementusInventoryUpdateOperation::Remove);
+	ToInventory->UpdateElementusItems(AcceptedItems, EElementusInventoryUpdateOperation::Add);
+
+	return true;
+}
+
+/* Operations of a single inventory, validated by the same task */
+struct FElementusBulkInventoryGroup
+{
+	UElementusInventoryComponent* Inventory = nullptr;
+	TArray<int32> Operations;
+};
+
+static void ValidateBulkInventoryGroup(const FElementusBulkInventoryGroup& Group, const TArray<FElementusBulkInventoryOperation>& Operations,
+                                       TArray<TArray<FElementusItemInfo>>& OutAcceptedItems)
+{
+	const UElementusInventoryComponent* const Inventory = Group.Inventory;
+	const FElementusItemDefinitionCache& Cache = FElementusItemDefinitionCache::Get();
+
+	// Virtual state of the inventory after the operations accepted so far. Only reads the items: the index may be rebuilt lazily
+	FElementusVirtualInventory VirtualInventory = FElementusVirtualInventory::FromAllItems(Inventory);
+
+	for (const int32 OperationIndex : Group.Operations)
+	{
+		const FElementusBulkInventoryOperation& Operation = Operations[OperationIndex];
+		TArray<FElementusItemInfo>& AcceptedItems = OutAcceptedItems[OperationIndex];
+
+		if (Operation.Operation == EElementusBulkOperationType::ClearInventory)
+		{
+			VirtualInventory.Clear();
+			continue;
+		}
+
+		for (const FElementusItemInfo& Item : Operation.Items)
+		{
+			FElementusItemDefinition ItemDefinition;
+			if (!UElementusInventoryFunctions::IsItemValid(Item) || !Cache.FindCachedDefinition(Item.ItemId, ItemDefinition))
+			{
+				continue;
+			}
+
+			if (Operation.Operation == EElementusBulkOperationType::AddItems)
+			{
+				if (VirtualInventory.GetRequiredSlots(Item, ItemDefinition.bIsStackable) > VirtualInventory.GetNumAvailableSlots() || VirtualInventory.
+					GetWeight() + ItemDefinition.ItemWeight * Item.Quantity > Inventory->GetMaxWeight())
+				{
+					continue;
+				}
+
+				VirtualInventory.AddItem(Item, ItemDefinition);
 			}
 			else
 			{
-				return false;
+				if (VirtualInventory.GetQuantity(Item) < Item.Quantity)
+				{
+					continue;
+				}
+
+				VirtualInventory.RemoveItem(Item, ItemDefinition);
+			}
+
+			AcceptedItems.Add(Item);
+		}
+	}
+}
+
+TArray<int32> UElementusInventoryFunctions::ApplyBulkOperations(const TArray<FElementusBulkInventoryOperation>& Operations)
+{
+	ELEMENTUS_INVENTORY_SCOPE(BulkOperations);
+
+	TArray<int32> Output;
+	Output.Init(0, Operations.Num());
+
+	// Group the operations by inventory, keeping their order, so each inventory is validated by a single task
+	TArray<FElementusBulkInventoryGroup> Groups;
+	TMap<UElementusInventoryComponent*, int32> GroupsByInventory;
+
+	for (int32 Iterator = 0; Iterator < Operations.Num(); ++Iterator)
+	{
+		UElementusInventoryComponent* const Inventory = Operations[Iterator].Inventory;
+		if (!IsValid(Inventory) || Inventory->GetOwnerRole() != ROLE_Authority)
+		{
+			continue;
+		}
+
+		int32* GroupIndex = GroupsByInventory.Find(Inventory);
+		if (!GroupIndex)
+		{
+			GroupIndex = &GroupsByInventory.Add(Inventory, Groups.AddDefaulted());
+			Groups[*GroupIndex].Inventory = Inventory;
+		}
+
+		Groups[*GroupIndex].Operations.Add(Iterator);
+
+		// Missing definitions can only be loaded on the game thread, so they're requested before the parallel validation
+		for (const FElementusItemInfo& Item : Operations[Iterator].Items)
+		{
+			if (FElementusItemDefinition ItemDefinition; IsItemValid(Item))
+			{
+				FElementusItemDefinitionCache::Get().FindDefinition(Item.ItemId, ItemDefinition);
 			}
 		}
+	}
 
-		return bCanTradeIterator;
+	TArray<TArray<FElementusItemInfo>> AcceptedItems;
+	AcceptedItems.SetNum(Operations.Num());
+
+	ParallelFor(Groups.Num(), [&Groups, &Operations, &AcceptedItems](const int32 GroupIndex)
+	{
+		ValidateBulkInventoryGroup(Groups[GroupIndex], Operations, AcceptedItems);
 	});
 
+	for (const FElementusBulkInventoryGroup& Group : Groups)
+	{
+		FElementusInventoryScopedTransaction Transaction(Group.Inventory);
+
+		for (const int32 OperationIndex : Group.Operations)
+		{
+			switch (Operations[OperationIndex].Operation)
+			{
+			case EElementusBulkOperationType::ClearInventory:
+				Group.Inventory->ClearInventory();
+				break;
+
+			case EElementusBulkOperationType::AddItems:
+				Group.Inventory->UpdateElementusItems(AcceptedItems[OperationIndex], EElementusInventoryUpdateOperation::Add);
+				break;
+
+			case EElementusBulkOperationType::DiscardItems:
+				Group.Inventory->UpdateElementusItems(AcceptedItems[OperationIndex], EElementusInventoryUpdateOperation::Remove);
+				break;
+
+			default:
+				break;
+			}
+
+			Output[OperationIndex] = AcceptedItems[OperationIndex].Num();
+		}
+	}
+
+	UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Applied %d operation(s) to %d inventories"), *FString(__FUNCTION__), Operations.Num(),
+	       Groups.Num());
+
 	return Output;
 }
 
@@ -327,9 +890,9 @@ bool UElementusInventoryFunctions::IsItemStackable(const FElementusItemInfo& InI
 		return false;
 	}
 
-	if (const UElementusItemData* const ItemData = GetSingleItemDataById(InItemInfo.ItemId, {"Data"}))
+	if (FElementusItemDefinition ItemDefinition; FElementusItemDefinitionCache::Get().FindDefinition(InItemInfo.ItemId, ItemDefinition))
 	{
-		return ItemData->bIsStackable;
+		return ItemDefinition.bIsStackable;
 	}
 
 	return true;
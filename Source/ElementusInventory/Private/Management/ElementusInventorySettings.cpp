@@ -4,13 +4,17 @@
 
 #include "Management/ElementusInventorySettings.h"
 #include "LogElementusInventory.h"
+#include <Misc/Paths.h>
 
 #ifdef UE_INLINE_GENERATED_CPP_BY_NAME
 #include UE_INLINE_GENERATED_CPP_BY_NAME(ElementusInventorySettings)
 #endif
 
 UElementusInventorySettings::UElementusInventorySettings(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer),
-	bEnableInternalLogs(false)
+	bEnableInternalLogs(false), WeightValidationInterval(100), bUseCookedItemCatalog(false),
+	CookedItemCatalogPath(TEXT("ElementusInventory/ItemCatalog.bin")), bReplicateItemsToOwnerOnly(false),
+	MaxClientInteractionDistance(500.f), DedicatedServerBundlePolicy(EElementusBundlePolicyMode::Enforce),
+	DedicatedServerAllowedBundles({TEXT("Data"), TEXT("Custom")}), bEnableItemIndexing(true), bCompactItemRuns(true)
 {
 	CategoryName = TEXT("Plugins");
 }
@@ -21,6 +25,11 @@ const UElementusInventorySettings* UElementusInventorySettings::Get()
 	return Instance;
 }
 
+FString UElementusInventorySettings::GetCookedItemCatalogFilePath() const
+{
+	return FPaths::Combine(FPaths::ProjectContentDir(), CookedItemCatalogPath);
+}
+
 #if WITH_EDITOR
 void UElementusInventorySettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
@@ -0,0 +1,295 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "Management/ElementusInventorySubsystem.h"
+#include "Management/ElementusInventoryCache.h"
+#include "Components/ElementusInventoryComponent.h"
+#include "LogElementusInventory.h"
+#include "ElementusInventoryStats.h"
+#include <Engine/World.h>
+
+#ifdef UE_INLINE_GENERATED_CPP_BY_NAME
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ElementusInventorySubsystem)
+#endif
+
+UElementusInventorySubsystem* UElementusInventorySubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject))
+	{
+		return nullptr;
+	}
+
+	const UWorld* const World = WorldContextObject->GetWorld();
+	return IsValid(World) ? World->GetSubsystem<UElementusInventorySubsystem>() : nullptr;
+}
+
+void UElementusInventorySubsystem::Deinitialize()
+{
+	Pools = FElementusInventoryItemPools();
+	NumUnusedPoolEntries = 0;
+
+	Records.Empty();
+	FreeRecords.Empty();
+	DirtyRecords.Empty();
+	RecordsByInventory.Empty();
+
+	UpdateMemoryStats();
+
+	Super::Deinitialize();
+}
+
+void UElementusInventorySubsystem::RegisterInventory(UElementusInventoryComponent* Inventory)
+{
+	if (!IsValid(Inventory) || RecordsByInventory.Contains(Inventory))
+	{
+		return;
+	}
+
+	const int32 RecordIndex = FreeRecords.IsEmpty() ? Records.AddDefaulted() : FreeRecords.Pop(false);
+	Records[RecordIndex] = FElementusInventoryRecord();
+	Records[RecordIndex].Inventory = Inventory;
+
+	RecordsByInventory.Add(Inventory, RecordIndex);
+	MarkInventoryDirty(Inventory);
+}
+
+void UElementusInventorySubsystem::UnregisterInventory(UElementusInventoryComponent* Inventory)
+{
+	int32 RecordIndex;
+	if (!RecordsByInventory.RemoveAndCopyValue(Inventory, RecordIndex))
+	{
+		return;
+	}
+
+	FElementusInventoryRecord& Record = Records[RecordIndex];
+	ReleaseRecordRange(Record);
+
+	Record = FElementusInventoryRecord();
+	FreeRecords.Add(RecordIndex);
+}
+
+void UElementusInventorySubsystem::MarkInventoryDirty(UElementusInventoryComponent* Inventory)
+{
+	if (const int32* const RecordIndex = RecordsByInventory.Find(Inventory); RecordIndex && !Records[*RecordIndex].bIsDirty)
+	{
+		Records[*RecordIndex].bIsDirty = true;
+		DirtyRecords.Add(*RecordIndex);
+	}
+}
+
+TArray<UElementusInventoryComponent*> UElementusInventorySubsystem::GetInventoriesWithItem(const FPrimaryElementusItemId& InItemId)
+{
+	TArray<UElementusInventoryComponent*> Output;
+
+	const FElementusItemHandle Handle = FElementusItemDefinitionCache::Get().FindItemHandle(InItemId);
+	if (!Handle.IsValid())
+	{
+		return Output;
+	}
+
+	FlushDirtyInventories();
+
+	TBitArray<> VisitedRecords(false, Records.Num());
+	for (int32 Iterator = 0; Iterator < Pools.Num(); ++Iterator)
+	{
+		if (const int32 Owner = Pools.Owners[Iterator]; Pools.ItemHandles[Iterator] == Handle && Pools.Quantities[Iterator] > 0 && !VisitedRecords[Owner])
+		{
+			VisitedRecords[Owner] = true;
+
+			if (UElementusInventoryComponent* const Inventory = GetRecordInventory(Owner))
+			{
+				Output.Add(Inventory);
+			}
+		}
+	}
+
+	return Output;
+}
+
+int64 UElementusInventorySubsystem::GetWorldItemQuantity(const FPrimaryElementusItemId& InItemId)
+{
+	const FElementusItemHandle Handle = FElementusItemDefinitionCache::Get().FindItemHandle(InItemId);
+	if (!Handle.IsValid())
+	{
+		return 0;
+	}
+
+	FlushDirtyInventories();
+
+	int64 Output = 0;
+	for (int32 Iterator = 0; Iterator < Pools.Num(); ++Iterator)
+	{
+		if (Pools.ItemHandles[Iterator] == Handle)
+		{
+			Output += FMath::Max(Pools.Quantities[Iterator], 0);
+		}
+	}
+
+	return Output;
+}
+
+TArray<UElementusInventoryComponent*> UElementusInventorySubsystem::GetRegisteredInventories() const
+{
+	TArray<UElementusInventoryComponent*> Output;
+	Output.Reserve(RecordsByInventory.Num());
+
+	for (const FElementusInventoryRecord& Iterator : Records)
+	{
+		if (UElementusInventoryComponent* const Inventory = Iterator.Inventory.Get())
+		{
+			Output.Add(Inventory);
+		}
+	}
+
+	return Output;
+}
+
+UElementusInventoryComponent* UElementusInventorySubsystem::GetRecordInventory(const int32 RecordIndex) const
+{
+	return Records.IsValidIndex(RecordIndex) ? Records[RecordIndex].Inventory.Get() : nullptr;
+}
+
+void UElementusInventorySubsystem::FlushDirtyInventories()
+{
+	ELEMENTUS_INVENTORY_SCOPE(SubsystemFlush);
+
+	if (DirtyRecords.IsEmpty())
+	{
+		return;
+	}
+
+	for (const int32 Iterator : DirtyRecords)
+	{
+		WriteRecord(Iterator);
+	}
+
+	DirtyRecords.Reset();
+
+	// Moving inventories to the end of the pools leaves gaps behind: compact once they take most of the pools
+	if (NumUnusedPoolEntries > 64 && NumUnusedPoolEntries > Pools.Num() / 2)
+	{
+		CompactPools();
+	}
+
+	UpdateMemoryStats();
+}
+
+void UElementusInventorySubsystem::WriteRecord(const int32 RecordIndex)
+{
+	FElementusInventoryRecord& Record = Records[RecordIndex];
+	Record.bIsDirty = false;
+
+	const UElementusInventoryComponent* const Inventory = Record.Inventory.Get();
+	if (!IsValid(Inventory))
+	{
+		ReleaseRecordRange(Record);
+		return;
+	}
+
+	// Each run of identical items takes a single entry
+	const TArrayView<const FElementusItemRun> Runs = Inventory->GetItemsView().GetRuns();
+
+	// Inventories that outgrow their range are moved to the end of the pools, with some slack to avoid moving again on the next additions
+	if (Runs.Num() > Record.Capacity)
+	{
+		ReleaseRecordRange(Record);
+
+		Record.Offset = Pools.Num();
+		Record.Capacity = Runs.Num() + FMath::Max(Runs.Num() / 2, 4);
+
+		const int32 NewNum = Pools.Num() + Record.Capacity;
+		Pools.Owners.SetNumUninitialized(NewNum);
+		Pools.ItemHandles.SetNum(NewNum);
+		Pools.Quantities.SetNumUninitialized(NewNum);
+	}
+
+	FElementusItemDefinitionCache& Cache = FElementusItemDefinitionCache::Get();
+
+	for (int32 Iterator = 0; Iterator < Record.Capacity; ++Iterator)
+	{
+		const int32 PoolIndex = Record.Offset + Iterator;
+
+		if (Iterator < Runs.Num())
+		{
+			const FElementusItemInfo& Item = Runs[Iterator].ItemInfo;
+
+			Pools.Owners[PoolIndex] = RecordIndex;
+			Pools.ItemHandles[PoolIndex] = Cache.InternItemId(Item.ItemId);
+			Pools.Quantities[PoolIndex] = Item.Quantity <= 0
+				                              ? Item.Quantity
+				                              : static_cast<int32>(FMath::Min<int64>(static_cast<int64>(Item.Quantity) * Runs[Iterator].RunLength, MAX_int32));
+		}
+		else
+		{
+			Pools.Owners[PoolIndex] = INDEX_NONE;
+			Pools.ItemHandles[PoolIndex] = FElementusItemHandle();
+			Pools.Quantities[PoolIndex] = 0;
+		}
+	}
+
+	Record.Num = Runs.Num();
+}
+
+void UElementusInventorySubsystem::ReleaseRecordRange(FElementusInventoryRecord& Record)
+{
+	for (int32 PoolIndex = Record.Offset; PoolIndex < Record.Offset + Record.Capacity; ++PoolIndex)
+	{
+		Pools.Owners[PoolIndex] = INDEX_NONE;
+		Pools.ItemHandles[PoolIndex] = FElementusItemHandle();
+		Pools.Quantities[PoolIndex] = 0;
+	}
+
+	NumUnusedPoolEntries += Record.Capacity;
+
+	Record.Offset = 0;
+	Record.Num = 0;
+	Record.Capacity = 0;
+}
+
+void UElementusInventorySubsystem::CompactPools()
+{
+	FElementusInventoryItemPools NewPools;
+
+	int32 NewNum = 0;
+	for (const FElementusInventoryRecord& Iterator : Records)
+	{
+		NewNum += Iterator.Capacity;
+	}
+
+	NewPools.Owners.Reserve(NewNum);
+	NewPools.ItemHandles.Reserve(NewNum);
+	NewPools.Quantities.Reserve(NewNum);
+
+	for (FElementusInventoryRecord& Record : Records)
+	{
+		if (Record.Capacity == 0)
+		{
+			continue;
+		}
+
+		const int32 NewOffset = NewPools.Num();
+
+		NewPools.Owners.Append(&Pools.Owners[Record.Offset], Record.Capacity);
+		NewPools.ItemHandles.Append(&Pools.ItemHandles[Record.Offset], Record.Capacity);
+		NewPools.Quantities.Append(&Pools.Quantities[Record.Offset], Record.Capacity);
+
+		Record.Offset = NewOffset;
+	}
+
+	UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Compacted the inventory item pools from %d to %d entries"), *FString(__FUNCTION__),
+	       Pools.Num(), NewPools.Num());
+
+	Pools = MoveTemp(NewPools);
+	NumUnusedPoolEntries = 0;
+}
+
+void UElementusInventorySubsystem::UpdateMemoryStats()
+{
+#if STATS
+	const int64 PoolsMemory = Pools.Owners.GetAllocatedSize() + Pools.ItemHandles.GetAllocatedSize() + Pools.Quantities.GetAllocatedSize();
+
+	ELEMENTUS_INVENTORY_MEMORY_DELTA(ItemPoolsMemory, PoolsMemory - ReportedPoolsMemory);
+	ReportedPoolsMemory = PoolsMemory;
+#endif
+}
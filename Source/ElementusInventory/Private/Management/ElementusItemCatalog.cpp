@@ -0,0 +1,400 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "Management/ElementusItemCatalog.h"
+#include "LogElementusInventory.h"
+#include <Algo/BinarySearch.h>
+#include <Algo/Sort.h>
+#include <Async/MappedFileHandle.h>
+#include <HAL/PlatformFileManager.h>
+#include <Misc/FileHelper.h>
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "The item catalog is stored and mapped as little-endian");
+
+namespace ElementusItemCatalog
+{
+	constexpr uint32 Magic = 0x43494945;
+	constexpr uint32 Version = 1u;
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 NumItems;
+		uint32 NumRelations;
+		uint32 NumRelationItems;
+		uint32 StringsSize;
+	};
+
+	/* Sorted by ItemId */
+	struct FItem
+	{
+		int32 ItemId;
+		uint32 NameOffset;
+		float ItemValue;
+		float ItemWeight;
+		uint32 FirstRelation;
+		uint16 NumRelations;
+		uint8 ItemType;
+		uint8 bIsStackable;
+	};
+
+	struct FRelation
+	{
+		uint32 TagOffset;
+		uint32 FirstItem;
+		uint32 NumItems;
+	};
+
+	static_assert(sizeof(FHeader) == 24 && sizeof(FItem) == 24 && sizeof(FRelation) == 12, "The item catalog layout must not depend on the compiler");
+
+	/* Layout: header, items, relations, relation item ids, null-terminated UTF-8 strings */
+	const FHeader& GetHeader(const uint8* InData)
+	{
+		return *reinterpret_cast<const FHeader*>(InData);
+	}
+
+	TArrayView<const FItem> GetItems(const uint8* InData)
+	{
+		return MakeArrayView(reinterpret_cast<const FItem*>(InData + sizeof(FHeader)), GetHeader(InData).NumItems);
+	}
+
+	TArrayView<const FRelation> GetRelations(const uint8* InData)
+	{
+		const uint8* const Begin = reinterpret_cast<const uint8*>(GetItems(InData).end());
+		return MakeArrayView(reinterpret_cast<const FRelation*>(Begin), GetHeader(InData).NumRelations);
+	}
+
+	TArrayView<const int32> GetRelationItems(const uint8* InData)
+	{
+		const uint8* const Begin = reinterpret_cast<const uint8*>(GetRelations(InData).end());
+		return MakeArrayView(reinterpret_cast<const int32*>(Begin), GetHeader(InData).NumRelationItems);
+	}
+
+	const ANSICHAR* GetStrings(const uint8* InData)
+	{
+		return reinterpret_cast<const ANSICHAR*>(GetRelationItems(InData).end());
+	}
+}
+
+FElementusItemCatalog& FElementusItemCatalog::Get()
+{
+	static FElementusItemCatalog Instance;
+	return Instance;
+}
+
+FElementusItemCatalog::~FElementusItemCatalog()
+{
+	Unload();
+}
+
+void FElementusItemCatalog::Build(const TArray<UElementusItemData*>& InItemDatas, TArray<uint8>& OutData)
+{
+	using namespace ElementusItemCatalog;
+
+	TArray<const UElementusItemData*> SortedDatas;
+	SortedDatas.Reserve(InItemDatas.Num());
+
+	for (const UElementusItemData* const Iterator : InItemDatas)
+	{
+		if (IsValid(Iterator))
+		{
+			SortedDatas.Add(Iterator);
+		}
+	}
+
+	Algo::SortBy(SortedDatas, &UElementusItemData::ItemId);
+
+	TArray<FItem> Items;
+	TArray<FRelation> Relations;
+	TArray<int32> RelationItems;
+	TArray<ANSICHAR> Strings;
+	TMap<FName, uint32> StringOffsets;
+
+	const auto AddString_Lambda = [&Strings, &StringOffsets](const FName& InName) -> uint32
+	{
+		if (const uint32* const Offset = StringOffsets.Find(InName))
+		{
+			return *Offset;
+		}
+
+		const uint32 NewOffset = Strings.Num();
+		const FTCHARToUTF8 Converter(*InName.ToString());
+
+		Strings.Append(Converter.Get(), Converter.Length());
+		Strings.Add('\0');
+
+		StringOffsets.Add(InName, NewOffset);
+		return NewOffset;
+	};
+
+	Items.Reserve(SortedDatas.Num());
+	for (const UElementusItemData* const Iterator : SortedDatas)
+	{
+		if (Iterator->ItemId < 0)
+		{
+			UE_LOG(LogElementusInventory, Warning, TEXT("%s: Item data %s has a negative id and was skipped"), *FString(__FUNCTION__), *Iterator->GetName());
+			continue;
+		}
+
+		if (!Items.IsEmpty() && Items.Last().ItemId == Iterator->ItemId)
+		{
+			UE_LOG(LogElementusInventory, Warning, TEXT("%s: Item data %s has a duplicated id %d and was skipped"), *FString(__FUNCTION__),
+			       *Iterator->GetName(), Iterator->ItemId);
+			continue;
+		}
+
+		// The num of relations is stored in 16 bits
+		if (Iterator->Relations.Num() > MaxNumRelations)
+		{
+			UE_LOG(LogElementusInventory, Warning, TEXT("%s: Item data %s has %d relations, more than the max of %d, and was skipped"),
+			       *FString(__FUNCTION__), *Iterator->GetName(), Iterator->Relations.Num(), MaxNumRelations);
+			continue;
+		}
+
+		FItem& NewItem = Items.AddZeroed_GetRef();
+		NewItem.ItemId = Iterator->ItemId;
+		NewItem.NameOffset = AddString_Lambda(Iterator->ItemName);
+		NewItem.ItemValue = Iterator->ItemValue;
+		NewItem.ItemWeight = Iterator->ItemWeight;
+		NewItem.ItemType = static_cast<uint8>(Iterator->ItemType);
+		NewItem.bIsStackable = Iterator->bIsStackable;
+		NewItem.FirstRelation = Relations.Num();
+
+		for (const TPair<FGameplayTag, FPrimaryElementusItemIdContainer>& Relation : Iterator->Relations)
+		{
+			FRelation& NewRelation = Relations.AddZeroed_GetRef();
+			NewRelation.TagOffset = AddString_Lambda(Relation.Key.GetTagName());
+			NewRelation.FirstItem = RelationItems.Num();
+
+			for (const FPrimaryElementusItemId& RelatedId : Relation.Value.Items)
+			{
+				if (uint32 RelatedItemId; RelatedId.GetCatalogItemId(RelatedItemId))
+				{
+					RelationItems.Add(static_cast<int32>(RelatedItemId));
+				}
+				else
+				{
+					UE_LOG(LogElementusInventory, Warning, TEXT("%s: Item data %s has a relation with %s, which isn't an item id"), *FString(__FUNCTION__),
+					       *Iterator->GetName(), *RelatedId.ToString());
+				}
+			}
+
+			NewRelation.NumItems = RelationItems.Num() - NewRelation.FirstItem;
+		}
+
+		NewItem.NumRelations = static_cast<uint16>(Relations.Num() - NewItem.FirstRelation);
+	}
+
+	FHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumItems = Items.Num();
+	Header.NumRelations = Relations.Num();
+	Header.NumRelationItems = RelationItems.Num();
+	Header.StringsSize = Strings.Num();
+
+	OutData.Reset(sizeof(FHeader) + Items.Num() * sizeof(FItem) + Relations.Num() * sizeof(FRelation) + RelationItems.Num() * sizeof(int32) +
+		Strings.Num());
+
+	OutData.Append(reinterpret_cast<const uint8*>(&Header), sizeof(FHeader));
+	OutData.Append(reinterpret_cast<const uint8*>(Items.GetData()), Items.Num() * sizeof(FItem));
+	OutData.Append(reinterpret_cast<const uint8*>(Relations.GetData()), Relations.Num() * sizeof(FRelation));
+	OutData.Append(reinterpret_cast<const uint8*>(RelationItems.GetData()), RelationItems.Num() * sizeof(int32));
+	OutData.Append(reinterpret_cast<const uint8*>(Strings.GetData()), Strings.Num());
+}
+
+bool FElementusItemCatalog::Load(const FString& InFilePath)
+{
+	Unload();
+
+	if (IMappedFileHandle* const NewMappedFile = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*InFilePath))
+	{
+		MappedFile.Reset(NewMappedFile);
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	if (MappedRegion.IsValid())
+	{
+		Data = MappedRegion->GetMappedPtr();
+		DataSize = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(LoadedData, *InFilePath, FILEREAD_Silent))
+	{
+		Data = LoadedData.GetData();
+		DataSize = LoadedData.Num();
+	}
+	else
+	{
+		UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Item catalog %s not found"), *FString(__FUNCTION__), *InFilePath);
+		Unload();
+		return false;
+	}
+
+	if (!ValidateData())
+	{
+		UE_LOG(LogElementusInventory, Error, TEXT("%s: Item catalog %s is invalid or was cooked by another version"), *FString(__FUNCTION__),
+		       *InFilePath);
+		Unload();
+		return false;
+	}
+
+	UE_LOG(LogElementusInventory_Internal, Display, TEXT("%s: Loaded %d items from the item catalog %s"), *FString(__FUNCTION__), Num(), *InFilePath);
+	return true;
+}
+
+void FElementusItemCatalog::Unload()
+{
+	Data = nullptr;
+	DataSize = 0;
+
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	LoadedData.Empty();
+}
+
+bool FElementusItemCatalog::IsLoaded() const
+{
+	return Data != nullptr;
+}
+
+int32 FElementusItemCatalog::Num() const
+{
+	return IsLoaded() ? ElementusItemCatalog::GetHeader(Data).NumItems : 0;
+}
+
+bool FElementusItemCatalog::ValidateData() const
+{
+	using namespace ElementusItemCatalog;
+
+	if (DataSize < static_cast<int64>(sizeof(FHeader)))
+	{
+		return false;
+	}
+
+	const FHeader& Header = GetHeader(Data);
+	if (Header.Magic != Magic || Header.Version != Version)
+	{
+		return false;
+	}
+
+	const int64 ExpectedSize = sizeof(FHeader) + static_cast<int64>(Header.NumItems) * sizeof(FItem) + static_cast<int64>(Header.NumRelations) *
+		sizeof(FRelation) + static_cast<int64>(Header.NumRelationItems) * sizeof(int32) + Header.StringsSize;
+
+	if (ExpectedSize != DataSize || (Header.StringsSize > 0 && GetStrings(Data)[Header.StringsSize - 1] != '\0'))
+	{
+		return false;
+	}
+
+	const TArrayView<const FItem> Items = GetItems(Data);
+	for (int32 Iterator = 0; Iterator < Items.Num(); ++Iterator)
+	{
+		const FItem& Item = Items[Iterator];
+		if ((Iterator > 0 && Items[Iterator - 1].ItemId >= Item.ItemId) || Item.NameOffset >= Header.StringsSize ||
+			static_cast<uint64>(Item.FirstRelation) + Item.NumRelations > Header.NumRelations)
+		{
+			return false;
+		}
+	}
+
+	for (const FRelation& Iterator : GetRelations(Data))
+	{
+		if (Iterator.TagOffset >= Header.StringsSize || static_cast<uint64>(Iterator.FirstItem) + Iterator.NumItems > Header.NumRelationItems)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int32 FElementusItemCatalog::FindItemIndex(const FPrimaryAssetId& InItemId) const
+{
+	uint32 CatalogItemId;
+	if (!IsLoaded() || !FPrimaryElementusItemId(InItemId).GetCatalogItemId(CatalogItemId))
+	{
+		return INDEX_NONE;
+	}
+
+	return Algo::BinarySearchBy(ElementusItemCatalog::GetItems(Data), static_cast<int32>(CatalogItemId), &ElementusItemCatalog::FItem::ItemId);
+}
+
+FElementusItemDefinition FElementusItemCatalog::MakeDefinition(const int32 InItemIndex) const
+{
+	const ElementusItemCatalog::FItem& Item = ElementusItemCatalog::GetItems(Data)[InItemIndex];
+
+	FElementusItemDefinition Output;
+	Output.ItemId = Item.ItemId;
+	Output.ItemName = GetName(Item.NameOffset);
+	Output.ItemType = static_cast<EElementusItemType>(Item.ItemType);
+	Output.bIsStackable = Item.bIsStackable != 0;
+	Output.ItemValue = Item.ItemValue;
+	Output.ItemWeight = Item.ItemWeight;
+
+	return Output;
+}
+
+FName FElementusItemCatalog::GetName(const uint32 InOffset) const
+{
+	return FName(UTF8_TO_TCHAR(ElementusItemCatalog::GetStrings(Data) + InOffset));
+}
+
+bool FElementusItemCatalog::FindDefinition(const FPrimaryAssetId& InItemId, FElementusItemDefinition& OutDefinition) const
+{
+	const int32 ItemIndex = FindItemIndex(InItemId);
+	if (ItemIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutDefinition = MakeDefinition(ItemIndex);
+	return true;
+}
+
+bool FElementusItemCatalog::FindRelations(const FPrimaryAssetId& InItemId, TMap<FGameplayTag, FPrimaryElementusItemIdContainer>& OutRelations) const
+{
+	using namespace ElementusItemCatalog;
+
+	const int32 ItemIndex = FindItemIndex(InItemId);
+	if (ItemIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FItem& Item = GetItems(Data)[ItemIndex];
+	const TArrayView<const FRelation> Relations = GetRelations(Data).Slice(Item.FirstRelation, Item.NumRelations);
+	const TArrayView<const int32> RelationItems = GetRelationItems(Data);
+
+	OutRelations.Reset();
+	OutRelations.Reserve(Relations.Num());
+
+	for (const FRelation& Iterator : Relations)
+	{
+		// Tags removed since the catalog was cooked are dropped
+		const FGameplayTag Tag = FGameplayTag::RequestGameplayTag(GetName(Iterator.TagOffset), false);
+		if (!Tag.IsValid())
+		{
+			continue;
+		}
+
+		FPrimaryElementusItemIdContainer& Container = OutRelations.FindOrAdd(Tag);
+		Container.Items.Reserve(Container.Items.Num() + Iterator.NumItems);
+
+		for (const int32 RelatedItemId : RelationItems.Slice(Iterator.FirstItem, Iterator.NumItems))
+		{
+			Container.Items.Add(FPrimaryElementusItemId::MakeCatalogItemId(RelatedItemId));
+		}
+	}
+
+	return true;
+}
+
+void FElementusItemCatalog::ForEachDefinition(TFunctionRef<void(const FPrimaryAssetId&, const FElementusItemDefinition&)> InFunction) const
+{
+	for (int32 Iterator = 0; Iterator < Num(); ++Iterator)
+	{
+		const FElementusItemDefinition Definition = MakeDefinition(Iterator);
+		InFunction(FPrimaryElementusItemId::MakeCatalogItemId(Definition.ItemId), Definition);
+	}
+}
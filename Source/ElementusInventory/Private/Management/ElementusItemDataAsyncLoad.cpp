@@ -0,0 +1,114 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "Management/ElementusItemDataAsyncLoad.h"
+#include "Components/ElementusInventoryComponent.h"
+#include <Engine/StreamableManager.h>
+
+#ifdef UE_INLINE_GENERATED_CPP_BY_NAME
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ElementusItemDataAsyncLoad)
+#endif
+
+UElementusItemDataAsyncLoad* UElementusItemDataAsyncLoad::LoadItemDataArrayAsync(UObject* WorldContextObject, const TArray<FPrimaryElementusItemId>& InIDs,
+                                                                                 const TArray<FName>& InBundles)
+{
+	UElementusItemDataAsyncLoad* const Task = CreateTask(WorldContextObject, InBundles);
+	Task->ItemIds = InIDs;
+
+	return Task;
+}
+
+UElementusItemDataAsyncLoad* UElementusItemDataAsyncLoad::LoadInventoryItemDataAsync(UObject* WorldContextObject,
+                                                                                     const UElementusInventoryComponent* Inventory,
+                                                                                     const TArray<FName>& InBundles)
+{
+	UElementusItemDataAsyncLoad* const Task = CreateTask(WorldContextObject, InBundles);
+
+	if (IsValid(Inventory))
+	{
+		for (const FElementusItemRun& Iterator : Inventory->GetItemsView().GetRuns())
+		{
+			if (UElementusInventoryFunctions::IsItemValid(Iterator.ItemInfo))
+			{
+				Task->ItemIds.AddUnique(Iterator.ItemInfo.ItemId);
+			}
+		}
+	}
+
+	return Task;
+}
+
+UElementusItemDataAsyncLoad* UElementusItemDataAsyncLoad::SearchElementusItemDataAsync(UObject* WorldContextObject, const EElementusSearchType SearchType,
+                                                                                       const FString& SearchString, const TArray<FName>& InBundles)
+{
+	UElementusItemDataAsyncLoad* const Task = CreateTask(WorldContextObject, InBundles);
+	Task->bIsSearch = true;
+	Task->SearchType = SearchType;
+	Task->SearchString = SearchString;
+
+	return Task;
+}
+
+UElementusItemDataAsyncLoad* UElementusItemDataAsyncLoad::CreateTask(UObject* WorldContextObject, const TArray<FName>& InBundles)
+{
+	UElementusItemDataAsyncLoad* const Task = NewObject<UElementusItemDataAsyncLoad>();
+	Task->Bundles = InBundles;
+	Task->RegisterWithGameInstance(WorldContextObject);
+
+	return Task;
+}
+
+void UElementusItemDataAsyncLoad::Activate()
+{
+	Super::Activate();
+
+	const FElementusItemDataArrayLoaded Delegate = FElementusItemDataArrayLoaded::CreateUObject(this, &UElementusItemDataAsyncLoad::OnItemDatasLoaded);
+
+	if (bIsSearch)
+	{
+		StreamableHandle = UElementusInventoryFunctions::SearchElementusItemDataAsync(SearchType, SearchString, Bundles, Delegate);
+	}
+	else
+	{
+		StreamableHandle = UElementusInventoryFunctions::LoadItemDataArrayAsync(ItemIds, Bundles, Delegate);
+	}
+
+	// Already loaded items complete the task right away
+	if (bHasCompleted)
+	{
+		StreamableHandle.Reset();
+	}
+}
+
+void UElementusItemDataAsyncLoad::Cancel()
+{
+	if (StreamableHandle.IsValid())
+	{
+		StreamableHandle->CancelHandle();
+		StreamableHandle.Reset();
+	}
+
+	OnLoaded.Clear();
+	OnFailed.Clear();
+
+	SetReadyToDestroy();
+}
+
+void UElementusItemDataAsyncLoad::OnItemDatasLoaded(const TArray<UElementusItemData*>& ItemDatas)
+{
+	bHasCompleted = true;
+
+	// Searches may not match any item, so only id loads are reported as failures
+	if (UElementusInventoryFunctions::HasEmptyParam(ItemDatas) && !bIsSearch)
+	{
+		OnFailed.Broadcast(ItemDatas);
+	}
+	else
+	{
+		OnLoaded.Broadcast(ItemDatas);
+	}
+
+	StreamableHandle.Reset();
+	SetReadyToDestroy();
+}
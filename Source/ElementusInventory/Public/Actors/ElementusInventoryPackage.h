@@ -29,6 +29,17 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void GetItemFromPackage(const TArray<FElementusItemInfo> ItemInfo, UElementusInventoryComponent* ToInventory);
 
+	/**
+	 * Add the player controlling the given actor to the viewers of this package. Authority only
+	 * If the package inventory replicates its items to the owner only, they're replicated to the viewers instead. Several players can view it at once
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	void OpenPackage(AActor* Opener);
+
+	/* Remove the player controlling the given actor from the viewers of this package, or all viewers if null. Authority only */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	void ClosePackage(AActor* Closer = nullptr);
+
 	/* Set this package to auto destroy when its empty */
 	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void SetDestroyOnEmpty(const bool bDestroy);
@@ -39,6 +50,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	/* Should this package auto destroy when empty? */
@@ -49,4 +61,12 @@ protected:
 	/* Destroy this package (Call Destroy()) */
 	UFUNCTION(BlueprintNativeEvent, Category = "Elementus Inventory")
 	void BeginPackageDestruction();
+
+private:
+	/* Net condition group of the package inventory: only the player controllers in this group receive it */
+	FName ViewerGroup;
+
+	TArray<TWeakObjectPtr<APlayerController>> Viewers;
+
+	void RemoveViewer(APlayerController* const Viewer);
 };
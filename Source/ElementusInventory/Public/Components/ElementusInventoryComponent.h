@@ -8,6 +8,10 @@
 #include <GameplayTagContainer.h>
 #include <Components/ActorComponent.h>
 #include "Management/ElementusInventoryData.h"
+#include "Components/ElementusInventoryIndex.h"
+#include "Components/ElementusInventoryReplication.h"
+#include "Components/ElementusInventoryView.h"
+#include "Management/ElementusInventoryCache.h"
 #include "ElementusInventoryComponent.generated.h"
 
 UENUM(Category = "Elementus Inventory | Enumerations")
@@ -18,7 +22,7 @@ enum class EElementusInventoryUpdateOperation : uint8
 	Remove
 };
 
-UENUM(Category = "Elementus Inventory | Enumerations")
+UENUM(BlueprintType, Category = "Elementus Inventory | Enumerations")
 enum class EElementusInventorySortingMode : uint8
 {
 	ID,
@@ -33,13 +37,87 @@ enum class EElementusInventorySortingMode : uint8
 	Tags
 };
 
-UENUM(Category = "Elementus Inventory | Enumerations")
+UENUM(BlueprintType, Category = "Elementus Inventory | Enumerations")
 enum class EElementusInventorySortingOrientation : uint8
 {
 	Ascending,
 	Descending
 };
 
+USTRUCT(BlueprintType, Category = "Elementus Inventory | Structures")
+struct FElementusInventorySortingKey
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elementus Inventory")
+	EElementusInventorySortingMode Mode = EElementusInventorySortingMode::ID;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elementus Inventory")
+	EElementusInventorySortingOrientation Orientation = EElementusInventorySortingOrientation::Ascending;
+};
+
+UENUM(Category = "Elementus Inventory | Enumerations")
+enum class EElementusInventoryCommandType : uint8
+{
+	AddItems,
+	DiscardItems,
+	DiscardItemIndexes,
+	GiveItemsTo,
+	GetItemsFrom,
+	GiveItemIndexesTo,
+	GetItemIndexesFrom,
+	ClearInventory
+};
+
+class UElementusInventoryComponent;
+
+/* Inventory operation requested by a client, sent to the server with the other operations requested in the same frame */
+USTRUCT(Category = "Elementus Inventory | Structures")
+struct FElementusInventoryCommand
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	EElementusInventoryCommandType Type = EElementusInventoryCommandType::AddItems;
+
+	UPROPERTY()
+	UElementusInventoryComponent* OtherInventory = nullptr;
+
+	UPROPERTY()
+	TArray<FElementusItemInfo> Items;
+
+	UPROPERTY()
+	TArray<int32> ItemIndexes;
+};
+
+/* Lightweight view of an inventory replicated to the connections that don't own it, when the items are only replicated to the owner */
+USTRUCT(BlueprintType, Category = "Elementus Inventory | Structures")
+struct FElementusInventorySummary
+{
+	GENERATED_BODY()
+
+	bool operator==(const FElementusInventorySummary& Other) const
+	{
+		return NumItems == Other.NumItems && Weight == Other.Weight && VisibleItems == Other.VisibleItems;
+	}
+
+	bool operator!=(const FElementusInventorySummary& Other) const
+	{
+		return !(*this == Other);
+	}
+
+	/* Num of valid slots of the inventory */
+	UPROPERTY(BlueprintReadOnly, Category = "Elementus Inventory")
+	int32 NumItems = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Elementus Inventory")
+	float Weight = 0.f;
+
+	/* Items that match the visible tags of the inventory, like equipped gear */
+	UPROPERTY(BlueprintReadOnly, Category = "Elementus Inventory")
+	TArray<FElementusItemInfo> VisibleItems;
+};
+
 USTRUCT(Category = "Elementus Inventory | Structures")
 struct FItemModifierData
 {
@@ -63,6 +141,9 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FElementusInventoryUpdate);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FElementusInventoryEmpty);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FElementusInventoryItemUpdate, const int32, SlotIndex, const FElementusItemInfo&, ItemInfo,
+                                               const EElementusInventorySlotUpdate, UpdateType);
+
 UCLASS(Blueprintable, ClassGroup = (Custom), Category = "Elementus Inventory | Classes", EditInlineNew, meta = (BlueprintSpawnableComponent))
 class ELEMENTUSINVENTORY_API UElementusInventoryComponent : public UActorComponent
 {
@@ -71,19 +152,50 @@ class ELEMENTUSINVENTORY_API UElementusInventoryComponent : public UActorCompone
 public:
 	explicit UElementusInventoryComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
-	/* Experimental parameter to assist using empty slots in the inventory: If true, will replace empty slots with empty item info */
+	/**
+	 * Experimental parameter to assist using empty slots in the inventory: If true, will replace empty slots with empty item info
+	 * New items are placed in the first empty slot, so the slot of each item stays the same while it's in the inventory.
+	 * If the max num of items is set, the inventory always has that num of slots, like a fixed grid
+	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elementus Inventory")
 	bool bAllowEmptySlots;
 
+	/* Keep a lookup table from item id to slots to speed up the find functions. Can be disabled for tiny inventories where a linear search is cheaper */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elementus Inventory")
+	bool bEnableItemIndexing;
+
+	/**
+	 * Store and replicate consecutive identical items, like expanded non-stackable items, as a single run. Slots are still read and notified one
+	 * per item. Disabling it keeps one run per slot, for inventories where neighbor slots rarely match
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elementus Inventory")
+	bool bCompactItemRuns;
+
+	/* Items with any of these tags, like equipped gear, are also sent to the connections that don't own this inventory */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elementus Inventory")
+	FGameplayTagContainer SummaryVisibleTags;
+
+	/* Is this inventory replicating its items only to its owning connection? */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	bool GetReplicateItemsToOwnerOnly() const;
+
+	/* Replicate the items only to the owning connection, or to all connections. Authority only */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Elementus Inventory")
+	void SetReplicateItemsToOwnerOnly(const bool bOwnerOnly);
+
 	/* Get the current inventory weight */
 	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
 	float GetCurrentWeight() const;
 
+	/* Get the current value of all items in this inventory */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	float GetCurrentValue() const;
+
 	/* Get the max inventory weight */
 	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
 	float GetMaxWeight() const;
 
-	/* Get the current num of items in this inventory */
+	/* Get the current num of items in this inventory. The empty slots of a fixed grid aren't counted */
 	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
 	int32 GetCurrentNumItems() const;
 
@@ -91,6 +203,14 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
 	int32 GetMaxNumItems() const;
 
+	/* Get the num of slots that can still receive new items, including the empty slots if bAllowEmptySlots is true */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	int32 GetNumAvailableSlots() const;
+
+	/* Get the summary of this inventory. On connections that don't own it, it's all that is replicated if the items are only sent to the owner */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	FElementusInventorySummary GetInventorySummary() const;
+
 	/* Called on every inventory update */
 	UPROPERTY(BlueprintAssignable, Category = "Elementus Inventory")
 	FElementusInventoryUpdate OnInventoryUpdate;
@@ -99,14 +219,63 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Elementus Inventory")
 	FElementusInventoryEmpty OnInventoryEmpty;
 
-	/* Get the items that this inventory have */
+	/* Called for each slot that was added, changed or removed in the last inventory update */
+	UPROPERTY(BlueprintAssignable, Category = "Elementus Inventory")
+	FElementusInventoryItemUpdate OnInventoryItemUpdate;
+
+	/* Get a copy of the items that this inventory have, one per slot. Use GetItemsView in C++ to avoid the copy */
 	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
 	TArray<FElementusItemInfo> GetItemsArray() const;
 
-	/* Get a reference of the item at given index */
-	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	/* Read-only view over the slots of this inventory, without copying them */
+	const FElementusItemSlots& GetItemsView() const
+	{
+		return ItemSlots;
+	}
+
+	/* Read-only view over the items that match the given predicate */
+	template <typename PredicateType>
+	TElementusItemFilterView<PredicateType> ViewItems(PredicateType Predicate) const
+	{
+		return MakeElementusItemFilterView(GetItemsView(), MoveTemp(Predicate));
+	}
+
+	/* Read-only view over the items with the given id */
+	auto ViewItemsWithId(const FPrimaryElementusItemId& InId) const
+	{
+		return ViewItems([InId](const FElementusItemInfo& Item)
+		{
+			return Item.ItemId == InId;
+		});
+	}
+
+	/* Read-only view over the items that have the given tag or one of its children */
+	auto ViewItemsWithTag(const FGameplayTag& InTag) const
+	{
+		return ViewItems([InTag](const FElementusItemInfo& Item)
+		{
+			return Item.Tags.HasTag(InTag);
+		});
+	}
+
+	/* Read-only view over the items of the given type */
+	auto ViewItemsWithType(const EElementusItemType InType) const
+	{
+		return ViewItems([InType](const FElementusItemInfo& Item)
+		{
+			FElementusItemDefinition ItemDefinition;
+			return FElementusItemDefinitionCache::Get().FindDefinition(Item.ItemId, ItemDefinition) && ItemDefinition.ItemType == InType;
+		});
+	}
+
+	/* Get a reference of the item at given index. Changes through the reference aren't replicated or weighted until the next update: prefer SetItemAt */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	FElementusItemInfo& GetItemReferenceAt(const int32 Index);
 
+	/* Replace the item at given index, keeping the weight, the lookups and the replicated items up to date. Returns false if the index is invalid */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Elementus Inventory")
+	bool SetItemAt(const int32 Index, const FElementusItemInfo& InItemInfo);
+
 	/* Get a copy of the item at given index */
 	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
 	FElementusItemInfo GetItemCopyAt(const int32 Index) const;
@@ -119,6 +288,18 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
 	virtual bool CanGiveItem(const FElementusItemInfo InItemInfo) const;
 
+	/* Get the total quantity of the items with the same id, level and tags of the specified info */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	int32 GetItemQuantity(const FElementusItemInfo& InItemInfo) const;
+
+	/* Get the total quantity of the items with the specified id, regardless of level and tags */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	int32 GetItemQuantityWithId(const FPrimaryElementusItemId& InId) const;
+
+	/* Check if this inventory holds all the required items. Requirements for the same item are summed */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	bool HasAllItems(const TArray<FElementusItemInfo>& Requirements) const;
+
 	/* Find the first elementus item that matches the specified info */
 	UFUNCTION(BlueprintPure, Category = "Elementus Inventory", meta = (AutoCreateRefTerm = "IgnoreTags"))
 	bool FindFirstItemIndexWithInfo(const FElementusItemInfo& InItemInfo, int32& OutIndex, const FGameplayTagContainer& IgnoreTags,
@@ -158,56 +339,120 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	virtual void DebugInventory();
 
-	/* Remove all items from this inventory */
-	UFUNCTION(NetMulticast, Reliable, BlueprintCallable, Category = "Elementus Inventory")
+	/* Remove all items from this inventory. Runs on the authority and updates the clients through the replicated items, clients requests are queued */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void ClearInventory();
 
-	/* Update the current weight of this inventory */
-	UFUNCTION(Client, Unreliable, BlueprintCallable, Category = "Elementus Inventory")
+	/* Recompute the current weight and value from all items. Both are already kept up to date incrementally, on clients from the replicated slots */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void UpdateWeight();
 
+	// The functions below run immediately on the authority. On clients, they're queued and sent to the server in a single RPC per frame
+
 	/* Get items from another inventory */
-	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "Elementus Inventory")
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void GetItemIndexesFrom(UElementusInventoryComponent* OtherInventory, const TArray<int32>& ItemIndexes);
 
 	/* Give items to another inventory */
-	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "Elementus Inventory")
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void GiveItemIndexesTo(UElementusInventoryComponent* OtherInventory, const TArray<int32>& ItemIndexes);
 
 	/* Get items from another inventory */
-	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "Elementus Inventory")
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void GetItemsFrom(UElementusInventoryComponent* OtherInventory, const TArray<FElementusItemInfo>& Items);
 
 	/* Give items to another inventory */
-	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "Elementus Inventory")
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void GiveItemsTo(UElementusInventoryComponent* OtherInventory, const TArray<FElementusItemInfo>& Items);
 
 	/* Discard items from this inventory */
-	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "Elementus Inventory")
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void DiscardItemIndexes(const TArray<int32>& ItemIndexes);
 
 	/* Discard items from this inventory */
-	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "Elementus Inventory")
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void DiscardItems(const TArray<FElementusItemInfo>& Items);
 
 	/* Add items to this inventory */
-	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "Elementus Inventory")
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void AddItems(const TArray<FElementusItemInfo>& Items);
 
 	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void SortInventory(const EElementusInventorySortingMode Mode, const EElementusInventorySortingOrientation Orientation);
 
+	/* Stable sort using multiple keys: each key is only used to break ties of the previous ones. Invalid and empty slots are moved to the end */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	void SortInventoryByKeys(const TArray<FElementusInventorySortingKey>& SortingKeys);
+
+	/* Begin a transaction: changes are applied immediately, but validation, replication and update events run only once on commit. Authority only */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	void BeginInventoryTransaction();
+
+	/* Commit the current transaction, notifying all changes made since it began. Nested transactions are committed with the outermost one */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	void CommitInventoryTransaction();
+
+	/* Discard all changes made since the outermost transaction began */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	void RollbackInventoryTransaction();
+
+	/* Check if there's a transaction in progress in this inventory */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	bool IsInTransaction() const;
+
+	/**
+	 * Write the items, weight and value of this inventory to a compact binary snapshot
+	 * Portable snapshots store the tag names instead of their net indices: they're larger, but can be loaded after the gameplay tags change
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	void SaveInventorySnapshot(TArray<uint8>& OutData, const bool bPortable = false) const;
+
+	/**
+	 * Replace the items of this inventory with the contents of a snapshot. Authority only
+	 * Snapshots saved with the current item catalog are applied as is, others are validated and have their weight recomputed.
+	 * Fails if a non-portable snapshot was saved with another gameplay tag table
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	bool LoadInventorySnapshot(const TArray<uint8>& InData);
+
 protected:
-	/* Items that this inventory have */
-	UPROPERTY(ReplicatedUsing = OnRep_ElementusItems, EditAnywhere, BlueprintReadOnly, Category = "Elementus Inventory",
-		meta = (Getter = "GetItemsArray", ArrayClamp = "MaxNumItems"))
-	TArray<FElementusItemInfo> ElementusItems;
+	/**
+	 * Items placed in the slots when this inventory begins to play, formerly ElementusItems. Blueprints reading this property get the current items
+	 * through GetItemsArray, as they did before the items moved to the slots. Use GetItemsView in C++
+	 */
+	UPROPERTY(EditAnywhere, BlueprintGetter = GetItemsArray, Category = "Elementus Inventory",
+		meta = (DisplayName = "Elementus Items", ArrayClamp = "MaxNumItems"))
+	TArray<FElementusItemInfo> InitialItems;
+
+	/* Items that this inventory have, see bCompactItemRuns */
+	FElementusItemSlots ItemSlots;
+
+	/* Delta replicated mirror of the slots, synchronized by the authority on every inventory change */
+	UPROPERTY(ReplicatedUsing = OnRep_ElementusItems)
+	FElementusReplicatedItemArray ReplicatedItems;
+
+	/* Replicated to the connections that don't own this inventory instead of the items, see bReplicateItemsToOwnerOnly */
+	UPROPERTY(ReplicatedUsing = OnRep_InventorySummary)
+	FElementusInventorySummary InventorySummary;
+
+	/**
+	 * Replicate the items only to the owning connection. Other connections receive a summary with the num of items, the weight and the items
+	 * with SummaryVisibleTags. The default comes from the settings
+	 */
+	UPROPERTY(EditAnywhere, BlueprintGetter = GetReplicateItemsToOwnerOnly, BlueprintSetter = SetReplicateItemsToOwnerOnly, Category = "Elementus Inventory")
+	bool bReplicateItemsToOwnerOnly;
 
 	/* Current weight of this inventory */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Elementus Inventory", meta = (AllowPrivateAccess = "true"))
 	float CurrentWeight;
 
+	/* Current value of all items in this inventory */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Elementus Inventory", meta = (AllowPrivateAccess = "true"))
+	float CurrentValue;
+
+	virtual void PostInitProperties() override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	virtual void RefreshInventory();
@@ -226,22 +471,165 @@ private:
 	void ForceWeightUpdate();
 	void ForceInventoryValidation();
 
+	/* Lookup tables over the runs of the slots, notified of each change of the runs and rebuilt lazily by GetItemIndex when they're replaced */
+	mutable FElementusInventoryIndex ItemIndex;
+
+	/* Get the up to date item index or nullptr if indexing is disabled */
+	const FElementusInventoryIndex* GetItemIndex() const;
+
+	/* Invalidate the free slots after a structural change in the slots */
+	void MarkSlotsDirty();
+
+	/* Check if the inventory keeps exactly MaxNumItems slots, which requires bAllowEmptySlots */
+	bool HasFixedSlots() const;
+
+	/* Add empty slots until the fixed num of slots is reached, if the inventory has fixed slots */
+	void FillFixedSlots();
+
+	/* Empty slots that can receive new items if bAllowEmptySlots is true, rebuilt lazily after structural changes */
+	TBitArray<> FreeSlots;
+	bool bFreeSlotsDirty = true;
+
+	/* No slot before this one is free, so the search for free slots starts here instead of at the first slot */
+	int32 LowestFreeSlot = 0;
+
+	/* Place copies of a new item in the first empty slots if bAllowEmptySlots is true, and the remaining ones at the end of the items */
+	void PlaceNewItem(const FElementusItemInfo& InItemInfo, const int32 NumSlots = 1);
+
+	/* Replace the items in the given slots with empty slots that can be reused */
+	void ReleaseSlots(const int32 FirstSlot, const int32 NumSlots = 1);
+
+	friend struct FElementusReplicatedItem;
+	friend struct FElementusReplicatedItemArray;
+
+	/* Apply a replicated entry to the run with the same key on clients, queueing the notification of the slots it changed in place */
+	void ApplyReplicatedEntry(const FElementusReplicatedItem& InEntry, const EElementusInventorySlotUpdate UpdateType);
+
+	/* Save the runs from the given slot before the current replication update moves them, if they weren't saved yet */
+	void SaveRunsBeforeReplication(const int32 FirstSlot);
+
+	/* Queue the notification of the slots moved by the current replication update, comparing them with the saved runs */
+	void QueueReplicatedSlotUpdates();
+
+	void QueueSlotUpdate(const int32 SlotIndex, const EElementusInventorySlotUpdate UpdateType, const FElementusItemInfo& ItemInfo);
+
+	/* Queue the notification of each slot that differs between two layouts, applying the weight of the changes if bApplyWeightDeltas is true */
+	void QueueSlotUpdates(const TArrayView<const FElementusItemRun> OldRuns, const TArrayView<const FElementusItemRun> NewRuns, const bool bApplyWeightDeltas);
+
+	/* Send the current items to the replicated entries. Authority only */
+	void SyncReplicatedItems();
+
+	void BroadcastPendingSlotUpdates();
+
+	TArray<FElementusPendingSlotUpdate> PendingSlotUpdates;
+
+	/* First slot moved on clients by the current replication update, and the runs that held the slots from it before the update */
+	int32 FirstSlotChangedByReplication = INDEX_NONE;
+	TArray<FElementusItemRun> RunsBeforeReplication;
+
+	/* Ranges of slots written since the outermost transaction began, with their content before their first write */
+	TArray<FElementusItemRun> TransactionUndoLog;
+	TBitArray<> TransactionLoggedSlots;
+
+	/* Num of slots, weight and value at the beginning of the outermost transaction */
+	int32 TransactionNumSlots = 0;
+	float TransactionSnapshotWeight = 0.f;
+	float TransactionSnapshotValue = 0.f;
+
+	int32 TransactionDepth = 0;
+	bool bHasPendingInventoryChange = false;
+
+	/* Save the given slots to the undo log before they're written for the first time in the current transaction. Added slots aren't saved */
+	void SaveSlotsForRollback(const int32 FirstSlot, const int32 NumSlots = 1);
+
+	/* Save all slots from the given one before a change that moves or removes them */
+	void SaveSlotsFromForRollback(const int32 FirstSlot);
+
+	/* Apply the weight and value of the given quantity of an item to the current totals */
+	void ApplyItemWeightDelta(const FPrimaryElementusItemId& InItemId, const int32 QuantityDelta);
+
+#if !UE_BUILD_SHIPPING
+	/* Compare the incremental weight with a full recomputation every few mutations */
+	void CheckWeightDrift();
+
+	int32 MutationsSinceWeightValidation = 0;
+#endif
+
 public:
 	/* Add a item to this inventory */
 	void UpdateElementusItems(const TArray<FElementusItemInfo>& Modifiers, const EElementusInventoryUpdateOperation Operation);
 
 private:
-	UFUNCTION(Server, Reliable)
-	void Server_ProcessInventoryAddition_Internal(const TArray<FItemModifierData>& Modifiers);
+	void ProcessInventoryAddition_Internal(const TArray<FItemModifierData>& Modifiers);
+	void ProcessInventoryRemoval_Internal(const TArray<FItemModifierData>& Modifiers);
+
+	/* Commands requested by the owning client in the current frame */
+	TArray<FElementusInventoryCommand> PendingCommands;
+
+	/* Queue a command to be sent on the next tick, along with the other commands of this frame. Clients only */
+	void QueueInventoryCommand(FElementusInventoryCommand&& Command);
+
+	void FlushInventoryCommands();
 
 	UFUNCTION(Server, Reliable)
-	void Server_ProcessInventoryRemoval_Internal(const TArray<FItemModifierData>& Modifiers);
+	void Server_ProcessInventoryCommands(const TArray<FElementusInventoryCommand>& Commands);
+
+	void ExecuteInventoryCommand(const FElementusInventoryCommand& Command);
+
+	/* Check that the other inventory and the slot indexes of a command received from the owning client can be used */
+	bool IsValidClientCommand(const FElementusInventoryCommand& Command) const;
+
+	/* Check that the owning client can trade with the given inventory: owned by the same connection or within the max interaction distance */
+	bool CanClientInteractWith(const UElementusInventoryComponent* OtherInventory) const;
 
 	UFUNCTION(Category = "Elementus Inventory")
 	void OnRep_ElementusItems();
 
+	/* Update the replicated summary from the current items. Authority only */
+	void UpdateInventorySummary();
+
+	/* Apply bReplicateItemsToOwnerOnly to the replication conditions of the items and the summary. Authority only */
+	void UpdateReplicationConditions();
+
+	UFUNCTION(Category = "Elementus Inventory")
+	void OnRep_InventorySummary();
+
+	/* Report the allocated size of the items to the memory stats */
+	void UpdateMemoryStats();
+
+#if STATS
+	int64 ReportedItemsMemory = 0;
+	int64 ReportedReplicatedItemsMemory = 0;
+#endif
+
 protected:
 	/* Mark the inventory as dirty to update the replicated data and broadcast the events */
 	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
 	void NotifyInventoryChange();
 };
+
+/* Begins a transaction in the given inventory and commits it when leaving the scope */
+struct FElementusInventoryScopedTransaction
+{
+	explicit FElementusInventoryScopedTransaction(UElementusInventoryComponent* InInventory) : Inventory(InInventory)
+	{
+		if (Inventory.IsValid())
+		{
+			Inventory->BeginInventoryTransaction();
+		}
+	}
+
+	~FElementusInventoryScopedTransaction()
+	{
+		if (Inventory.IsValid() && Inventory->IsInTransaction())
+		{
+			Inventory->CommitInventoryTransaction();
+		}
+	}
+
+	FElementusInventoryScopedTransaction(const FElementusInventoryScopedTransaction&) = delete;
+	FElementusInventoryScopedTransaction& operator=(const FElementusInventoryScopedTransaction&) = delete;
+
+private:
+	TWeakObjectPtr<UElementusInventoryComponent> Inventory;
+};
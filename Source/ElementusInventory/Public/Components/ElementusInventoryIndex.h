@@ -0,0 +1,97 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include "Management/ElementusInventoryData.h"
+#include "Components/ElementusInventorySlots.h"
+
+/* Identifies the slots that are considered the same item by FElementusItemInfo::operator==: same id, level and tags */
+struct ELEMENTUSINVENTORY_API FElementusItemStackKey
+{
+	FElementusItemStackKey() = default;
+
+	explicit FElementusItemStackKey(const FElementusItemInfo& InItemInfo) : ItemId(InItemInfo.ItemId), Level(InItemInfo.Level), Tags(InItemInfo.Tags)
+	{
+	}
+
+	bool operator==(const FElementusItemStackKey& Other) const
+	{
+		return ItemId == Other.ItemId && Level == Other.Level && Tags == Other.Tags;
+	}
+
+	friend uint32 GetTypeHash(const FElementusItemStackKey& InKey)
+	{
+		// Tag containers are compared regardless of the tags order, so their hash must also be
+		uint32 TagsHash = 0u;
+		for (const FGameplayTag& Iterator : InKey.Tags)
+		{
+			TagsHash += GetTypeHash(Iterator);
+		}
+
+		return HashCombine(HashCombine(GetTypeHash(InKey.ItemId), GetTypeHash(InKey.Level)), TagsHash);
+	}
+
+	FPrimaryAssetId ItemId;
+	int32 Level = 1;
+	FGameplayTagContainer Tags;
+};
+
+/**
+ * Lookup tables over the slots of an inventory component, with one entry per run of identical items.
+ * Runs are identified by their order key, which doesn't change when other runs are resized or removed, so the tables are kept up to date by the
+ * changes of the runs without touching the entries of the other ones. Replacing all runs marks the tables as dirty and they're rebuilt in a single
+ * pass on the next lookup.
+ */
+struct ELEMENTUSINVENTORY_API FElementusInventoryIndex : public IElementusItemRunListener
+{
+	/* Check if the tables must be rebuilt before the next lookup */
+	bool IsDirty() const;
+
+	/* Invalidate the tables after the slots were changed without notifying the index */
+	void MarkDirty();
+
+	/* Rebuild all tables from the given slots, once per run */
+	void Rebuild(const FElementusItemSlots& InItems);
+
+	/* Changes of the runs. They do nothing if the tables are already dirty */
+	virtual void OnRunAdded(const FElementusItemRun& InRun) override;
+	virtual void OnRunRemoved(const FElementusItemRun& InRun) override;
+	virtual void OnRunResized(const FElementusItemRun& InRun, const int32 PreviousRunLength) override;
+	virtual void OnRunsReset() override;
+
+	/* Get the order keys of the runs holding the given id, in ascending order */
+	const TArray<int64>* FindRunsWithId(const FPrimaryAssetId& InId) const;
+
+	/* Get the order keys of the runs having all the given tags or one of their children, in ascending order. Returns false if no run can match */
+	bool FindRunsWithAllTags(const FGameplayTagContainer& InTags, TArray<int64>& OutRuns) const;
+
+	/* Get the total quantity of the slots holding the same id, level and tags of the given item */
+	int32 GetQuantity(const FElementusItemInfo& InItem) const;
+
+	/* Get the total quantity of the slots holding the given id, regardless of level and tags */
+	int32 GetQuantityWithId(const FPrimaryAssetId& InId) const;
+
+	void Reset();
+
+private:
+	void AddRun(const FElementusItemRun& InRun);
+	void AddQuantity(const FElementusItemInfo& InItem, const int32 QuantityDelta);
+
+	/**
+	 * Keyed by item id instead of FElementusItemHandle: the id is two FNames, so hashing and comparing it is already integer work, while a handle
+	 * would need a locked lookup in the definition cache for every change of the runs and every query
+	 */
+	TMap<FPrimaryAssetId, TArray<int64>> RunsById;
+
+	/* Inverted tag index: each explicit tag and all its parent tags point to the runs that have it */
+	TMap<FGameplayTag, TArray<int64>> RunsByTag;
+
+	/* Running quantity totals, updated with each run change */
+	TMap<FElementusItemStackKey, int32> QuantityByKey;
+	TMap<FPrimaryAssetId, int32> QuantityById;
+
+	bool bIsDirty = true;
+};
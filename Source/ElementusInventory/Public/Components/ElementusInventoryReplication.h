@@ -0,0 +1,119 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Net/Serialization/FastArraySerializer.h>
+#include "Management/ElementusInventoryData.h"
+#include "Components/ElementusInventorySlots.h"
+#include "ElementusInventoryReplication.generated.h"
+
+class UElementusInventoryComponent;
+struct FElementusReplicatedItemArray;
+
+UENUM(BlueprintType, Category = "Elementus Inventory | Enumerations")
+enum class EElementusInventorySlotUpdate : uint8
+{
+	Added,
+	Changed,
+	Removed
+};
+
+/* Replicated run of identical slots of an inventory component */
+USTRUCT(Category = "Elementus Inventory | Structures")
+struct FElementusReplicatedItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	FElementusReplicatedItem() = default;
+
+	explicit FElementusReplicatedItem(const FElementusItemInfo& InItemInfo, const int64 InOrderKey, const int32 InRunLength) : ItemInfo(InItemInfo),
+		OrderKey(InOrderKey), RunLength(InRunLength)
+	{
+	}
+
+	UPROPERTY()
+	FElementusItemInfo ItemInfo;
+
+	/**
+	 * Order key of the run in the owning inventory, see FElementusItemRun. The order of the replicated entries isn't preserved on clients,
+	 * so each entry is placed among the runs by its key. Unlike the first slot, the key doesn't change when previous runs are resized,
+	 * so only the changed runs are sent
+	 */
+	UPROPERTY()
+	int64 OrderKey = 0;
+
+	/* Number of consecutive slots holding this same item */
+	UPROPERTY()
+	int32 RunLength = 1;
+
+	void PreReplicatedRemove(const FElementusReplicatedItemArray& InArraySerializer);
+	void PostReplicatedAdd(const FElementusReplicatedItemArray& InArraySerializer);
+	void PostReplicatedChange(const FElementusReplicatedItemArray& InArraySerializer);
+};
+
+/* Order keys of the runs changed since the last sync of the replicated entries */
+struct ELEMENTUSINVENTORY_API FElementusDirtyRuns : public IElementusItemRunListener
+{
+	virtual void OnRunAdded(const FElementusItemRun& InRun) override;
+	virtual void OnRunRemoved(const FElementusItemRun& InRun) override;
+	virtual void OnRunResized(const FElementusItemRun& InRun, const int32 PreviousRunLength) override;
+	virtual void OnRunsReset() override;
+
+	void MarkKeyDirty(const int64 InOrderKey);
+
+	/* Changed keys, in no particular order and possibly repeated */
+	TArray<int64> Keys;
+
+	/* All entries must be compared with the runs. Until then, the changes of single runs aren't recorded */
+	bool bAllRunsDirty = true;
+};
+
+/* Delta replicated mirror of the inventory slots: only the runs that changed since the last update are sent */
+USTRUCT(Category = "Elementus Inventory | Structures")
+struct ELEMENTUSINVENTORY_API FElementusReplicatedItemArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	/**
+	 * Update the entries to match the runs of the given slots, marking only the changed entries as dirty. Returns true if something changed.
+	 * Only the runs recorded in DirtyRuns are compared, unless all runs were replaced
+	 */
+	bool SyncFromItems(const FElementusItemSlots& InItems);
+
+	/* Compare all entries with all runs, after the runs were replaced */
+	bool SyncAllFromItems(const FElementusItemSlots& InItems);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FastArrayDeltaSerialize<FElementusReplicatedItem, FElementusReplicatedItemArray>(Entries, DeltaParms, *this);
+	}
+
+	UPROPERTY()
+	TArray<FElementusReplicatedItem> Entries;
+
+	/* Component that receives the slot updates. Not a property to avoid being copied from the archetype */
+	UElementusInventoryComponent* Owner = nullptr;
+
+	/* Listens to the runs of the owner's slots on the authority. Entries are kept sorted by key there, so they can be found by key */
+	FElementusDirtyRuns DirtyRuns;
+};
+
+template <>
+struct TStructOpsTypeTraits<FElementusReplicatedItemArray> : public TStructOpsTypeTraitsBase2<FElementusReplicatedItemArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
+};
+
+/* Slot update received from the replicated entries, broadcasted once the whole replication update is applied */
+struct FElementusPendingSlotUpdate
+{
+	int32 SlotIndex = INDEX_NONE;
+	EElementusInventorySlotUpdate UpdateType = EElementusInventorySlotUpdate::Changed;
+	FElementusItemInfo ItemInfo;
+};
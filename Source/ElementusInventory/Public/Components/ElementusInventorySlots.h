@@ -0,0 +1,383 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include "Management/ElementusInventoryData.h"
+
+/* Consecutive slots of an inventory holding the same item */
+struct ELEMENTUSINVENTORY_API FElementusItemRun
+{
+	FElementusItemRun() = default;
+
+	explicit FElementusItemRun(const FElementusItemInfo& InItemInfo, const int32 InRunLength) : ItemInfo(InItemInfo), RunLength(InRunLength)
+	{
+	}
+
+	/* Check if two slots hold the same item with the same quantity */
+	static bool HasSameContent(const FElementusItemInfo& A, const FElementusItemInfo& B)
+	{
+		return A == B && A.Quantity == B.Quantity;
+	}
+
+	/* Item of each slot of the run, with the quantity of a single slot */
+	FElementusItemInfo ItemInfo;
+
+	int32 RunLength = 1;
+
+	/* First slot of the run, kept up to date by the owning slots */
+	int32 FirstSlot = 0;
+
+	/* Position of the run among the others. Unlike the first slot, it doesn't change when the previous runs are resized or removed */
+	int64 OrderKey = 0;
+};
+
+/* Receives the changes of the runs of FElementusItemSlots, to keep the data stored per run up to date */
+class ELEMENTUSINVENTORY_API IElementusItemRunListener
+{
+public:
+	virtual ~IElementusItemRunListener() = default;
+
+	/* A run was inserted, or an existing run now holds another item */
+	virtual void OnRunAdded(const FElementusItemRun& InRun) = 0;
+
+	/* A run is about to be removed, or to hold another item */
+	virtual void OnRunRemoved(const FElementusItemRun& InRun) = 0;
+
+	/* The num of slots of a run changed */
+	virtual void OnRunResized(const FElementusItemRun& InRun, const int32 PreviousRunLength) = 0;
+
+	/* All runs were replaced or got new order keys */
+	virtual void OnRunsReset() = 0;
+};
+
+/**
+ * Run-length encoded slots of an inventory: consecutive identical items, like expanded non-stackable items, share a single run when compaction
+ * is enabled, so the memory follows the num of distinct runs instead of the num of slots. Items are still read and written per slot.
+ * Runs are always in slot order and their order keys are strictly increasing.
+ */
+class ELEMENTUSINVENTORY_API FElementusItemSlots
+{
+public:
+	/* Iterates the slots in order, yielding the item of the run that holds each slot */
+	class FConstIterator
+	{
+	public:
+		FConstIterator(const TArray<FElementusItemRun>& InRuns, const int32 InRunIndex, const int32 InSlot) : Runs(&InRuns), RunIndex(InRunIndex),
+			Slot(InSlot)
+		{
+		}
+
+		const FElementusItemInfo& operator*() const
+		{
+			return (*Runs)[RunIndex].ItemInfo;
+		}
+
+		const FElementusItemInfo* operator->() const
+		{
+			return &(*Runs)[RunIndex].ItemInfo;
+		}
+
+		FConstIterator& operator++()
+		{
+			if (const FElementusItemRun& Run = (*Runs)[RunIndex]; ++Slot >= Run.FirstSlot + Run.RunLength)
+			{
+				++RunIndex;
+			}
+
+			return *this;
+		}
+
+		/* Move to the first slot of the next run */
+		void SkipRun()
+		{
+			const FElementusItemRun& Run = (*Runs)[RunIndex];
+			Slot = Run.FirstSlot + Run.RunLength;
+			++RunIndex;
+		}
+
+		bool operator!=(const FConstIterator& Other) const
+		{
+			return Slot != Other.Slot;
+		}
+
+		explicit operator bool() const
+		{
+			return RunIndex < Runs->Num();
+		}
+
+		/* Slot of the current item */
+		int32 GetIndex() const
+		{
+			return Slot;
+		}
+
+		/* Run that holds the current slot */
+		int32 GetRunIndex() const
+		{
+			return RunIndex;
+		}
+
+	private:
+		const TArray<FElementusItemRun>* Runs;
+		int32 RunIndex;
+		int32 Slot;
+	};
+
+	FElementusItemSlots() = default;
+
+	/* The listeners aren't copied: they belong to the slots they were added to */
+	FElementusItemSlots(const FElementusItemSlots& Other);
+	FElementusItemSlots(FElementusItemSlots&& Other);
+
+	FElementusItemSlots& operator=(const FElementusItemSlots& Other);
+	FElementusItemSlots& operator=(FElementusItemSlots&& Other);
+
+	/* Notify the given listener of each change of the runs. It must outlive the slots or be removed */
+	void AddListener(IElementusItemRunListener* const InListener)
+	{
+		Listeners.AddUnique(InListener);
+	}
+
+	void RemoveListener(IElementusItemRunListener* const InListener)
+	{
+		Listeners.Remove(InListener);
+	}
+
+	/* Merge the identical neighbor runs. If false, each slot has its own run. Changing it rebuilds the runs */
+	void SetCompactRuns(const bool bInCompactRuns);
+
+	bool IsCompactingRuns() const
+	{
+		return bCompactRuns;
+	}
+
+	/* Num of slots */
+	int32 Num() const
+	{
+		return NumSlots;
+	}
+
+	bool IsEmpty() const
+	{
+		return NumSlots == 0;
+	}
+
+	bool IsValidIndex(const int32 Slot) const
+	{
+		return Slot >= 0 && Slot < NumSlots;
+	}
+
+	/* Get the item of the given slot. Searches the runs, prefer iterating them to read all slots */
+	const FElementusItemInfo& operator[](const int32 Slot) const;
+
+	/* Get the index of the run that holds the given slot */
+	int32 FindRunIndex(const int32 Slot) const;
+
+	/* Get the index of the run with the given order key, or INDEX_NONE if there's none */
+	int32 FindRunIndexByKey(const int64 InOrderKey) const;
+
+	TArrayView<const FElementusItemRun> GetRuns() const
+	{
+		return Runs;
+	}
+
+	/* Replace the items of the given slots */
+	void SetRange(const int32 FirstSlot, const int32 InNumSlots, const FElementusItemInfo& InItemInfo);
+
+	void Set(const int32 Slot, const FElementusItemInfo& InItemInfo)
+	{
+		SetRange(Slot, 1, InItemInfo);
+	}
+
+	/* Get a mutable reference of the item of a single slot, moving it to its own run. Invalidated by the next change */
+	FElementusItemInfo& GetMutable(const int32 Slot);
+
+	/* Add new slots with the given item at the end. Returns the first new slot */
+	int32 Add(const FElementusItemInfo& InItemInfo, const int32 InNumSlots = 1);
+
+	void Append(const TArrayView<const FElementusItemInfo> InItems);
+	void Append(const FElementusItemSlots& InSlots);
+
+	/* Remove the given slots, moving the next ones back */
+	void RemoveAt(const int32 FirstSlot, const int32 InNumSlots = 1);
+
+	/**
+	 * Mirror the runs of other slots, like the replicated runs of the authority: the runs are kept as given, without being merged and with the
+	 * given order keys, so they can be found again by key. Returns the index of the inserted run, or INDEX_NONE if the key is already used
+	 */
+	int32 InsertRunWithKey(const int64 InOrderKey, const FElementusItemInfo& InItemInfo, const int32 InRunLength);
+
+	/* Replace the item and the num of slots of the given run, moving the next runs if its length changed */
+	void SetRun(const int32 RunIndex, const FElementusItemInfo& InItemInfo, const int32 InRunLength);
+
+	/* Remove the given run, moving the next ones back */
+	void RemoveRun(const int32 RunIndex);
+
+	/* Remove all slots whose item matches the predicate, evaluated once per run. Returns the first removed slot or INDEX_NONE */
+	template <typename PredicateType>
+	int32 RemoveAll(PredicateType Predicate)
+	{
+		int32 FirstRemovedSlot = INDEX_NONE;
+		int32 NumKeptRuns = 0;
+
+		for (int32 Iterator = 0; Iterator < Runs.Num(); ++Iterator)
+		{
+			if (Predicate(Runs[Iterator].ItemInfo))
+			{
+				FirstRemovedSlot = FirstRemovedSlot == INDEX_NONE ? Runs[Iterator].FirstSlot : FirstRemovedSlot;
+				NotifyRunRemoved(Iterator);
+				continue;
+			}
+
+			// The runs on both sides of the removed ones may now be merged
+			if (bCompactRuns && NumKeptRuns > 0 && FElementusItemRun::HasSameContent(Runs[NumKeptRuns - 1].ItemInfo, Runs[Iterator].ItemInfo))
+			{
+				NotifyRunRemoved(Iterator);
+
+				const int32 PreviousRunLength = Runs[NumKeptRuns - 1].RunLength;
+				Runs[NumKeptRuns - 1].RunLength += Runs[Iterator].RunLength;
+				NotifyRunResized(NumKeptRuns - 1, PreviousRunLength);
+
+				continue;
+			}
+
+			if (NumKeptRuns != Iterator)
+			{
+				Runs[NumKeptRuns] = MoveTemp(Runs[Iterator]);
+			}
+
+			++NumKeptRuns;
+		}
+
+		if (NumKeptRuns != Runs.Num())
+		{
+			Runs.SetNum(NumKeptRuns, false);
+			UpdateFirstSlots(0);
+		}
+
+		return FirstRemovedSlot;
+	}
+
+	/**
+	 * Walk two run layouts side by side, calling Function(FirstSlot, NumSlots, OldItem, NewItem) for each range of slots covered by a single run
+	 * of both. OldItem is null for the slots past the old layout and NewItem for the slots past the new one. Runs must have their first slots set,
+	 * and both layouts must begin at the same slot, which may be a slot other than the first one to compare only the end of the layouts
+	 */
+	template <typename FunctionType>
+	static void DiffRuns(const TArrayView<const FElementusItemRun> OldRuns, const TArrayView<const FElementusItemRun> NewRuns, FunctionType Function)
+	{
+		int32 OldIndex = 0;
+		int32 NewIndex = 0;
+		int32 Slot = !OldRuns.IsEmpty() ? OldRuns[0].FirstSlot : !NewRuns.IsEmpty() ? NewRuns[0].FirstSlot : 0;
+
+		while (OldIndex < OldRuns.Num() || NewIndex < NewRuns.Num())
+		{
+			const FElementusItemRun* const OldRun = OldRuns.IsValidIndex(OldIndex) ? &OldRuns[OldIndex] : nullptr;
+			const FElementusItemRun* const NewRun = NewRuns.IsValidIndex(NewIndex) ? &NewRuns[NewIndex] : nullptr;
+
+			const int32 OldEnd = OldRun ? OldRun->FirstSlot + OldRun->RunLength : MAX_int32;
+			const int32 NewEnd = NewRun ? NewRun->FirstSlot + NewRun->RunLength : MAX_int32;
+			const int32 RangeEnd = FMath::Min(OldEnd, NewEnd);
+
+			Function(Slot, RangeEnd - Slot, OldRun ? &OldRun->ItemInfo : nullptr, NewRun ? &NewRun->ItemInfo : nullptr);
+			Slot = RangeEnd;
+
+			OldIndex += OldEnd == RangeEnd ? 1 : 0;
+			NewIndex += NewEnd == RangeEnd ? 1 : 0;
+		}
+	}
+
+	/* Remove the slots beyond the given num or add empty items until it's reached */
+	void SetNum(const int32 NewNum);
+
+	void Empty();
+
+	void Shrink()
+	{
+		Runs.Shrink();
+	}
+
+	/* Allocate room for the given num of runs, which is at most the num of slots */
+	void Reserve(const int32 NumRuns)
+	{
+		Runs.Reserve(NumRuns);
+	}
+
+	/* Get a copy of all slots, one item per slot */
+	TArray<FElementusItemInfo> ToArray() const;
+
+	SIZE_T GetAllocatedSize() const;
+
+	FConstIterator CreateConstIterator() const
+	{
+		return FConstIterator(Runs, 0, 0);
+	}
+
+	FConstIterator begin() const
+	{
+		return CreateConstIterator();
+	}
+
+	FConstIterator end() const
+	{
+		return FConstIterator(Runs, Runs.Num(), NumSlots);
+	}
+
+private:
+	/* Split the run that holds the given slot so that the slot begins a run. Returns the index of that run, or the num of runs for the end slot */
+	int32 SplitAt(const int32 Slot);
+
+	/* Merge the given run with its identical neighbors. Returns the index of the merged run */
+	int32 MergeWithNeighbors(const int32 RunIndex);
+
+	/* Insert new runs with the given item before the given run, a single one if compacting or one per slot otherwise */
+	void InsertRuns(const int32 RunIndex, const FElementusItemInfo& InItemInfo, const int32 InNumSlots);
+
+	/* Recompute the first slots from the given run and the num of slots */
+	void UpdateFirstSlots(const int32 FromRunIndex);
+
+	void NotifyRunAdded(const int32 RunIndex) const
+	{
+		for (IElementusItemRunListener* const Iterator : Listeners)
+		{
+			Iterator->OnRunAdded(Runs[RunIndex]);
+		}
+	}
+
+	void NotifyRunRemoved(const int32 RunIndex) const
+	{
+		for (IElementusItemRunListener* const Iterator : Listeners)
+		{
+			Iterator->OnRunRemoved(Runs[RunIndex]);
+		}
+	}
+
+	void NotifyRunResized(const int32 RunIndex, const int32 PreviousRunLength) const
+	{
+		for (IElementusItemRunListener* const Iterator : Listeners)
+		{
+			Iterator->OnRunResized(Runs[RunIndex], PreviousRunLength);
+		}
+	}
+
+	void NotifyRunsReset() const
+	{
+		for (IElementusItemRunListener* const Iterator : Listeners)
+		{
+			Iterator->OnRunsReset();
+		}
+	}
+
+	/* Give the given new runs evenly spaced keys between the keys of their neighbors, renumbering all runs if there's no room left */
+	void AssignOrderKeys(const int32 FirstRunIndex, const int32 NumRuns);
+	void RenumberOrderKeys();
+
+	TArray<FElementusItemRun> Runs;
+	int32 NumSlots = 0;
+	bool bCompactRuns = true;
+
+	TArray<IElementusItemRunListener*, TInlineAllocator<2>> Listeners;
+};
@@ -0,0 +1,50 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include "Management/ElementusInventoryData.h"
+#include "Components/ElementusInventorySlots.h"
+
+/* Contents of an inventory read from a snapshot */
+struct ELEMENTUSINVENTORY_API FElementusInventorySnapshotData
+{
+	FElementusItemSlots Items;
+	float Weight = 0.f;
+	float Value = 0.f;
+
+	/**
+	 * The snapshot was saved with the current tag table and item catalog: its items don't need to be validated and its weight and value can be used as is.
+	 * Otherwise, the items are validated against the current catalog when loaded
+	 */
+	bool bIsKnownValid = false;
+};
+
+/**
+ * Versioned binary format of the inventory persistence.
+ * Header: magic, version, flags, tag table hash, catalog hash, weight and value. Runs: slot count and item, see FElementusItemInfo::SaveSnapshot.
+ * Non-portable snapshots store tag net indices and require the same tag table. The catalog hash only decides if the items must be validated
+ */
+struct ELEMENTUSINVENTORY_API FElementusInventorySnapshot
+{
+	enum class EVersion : uint8
+	{
+		Initial = 1,
+		SeparateHashes,
+		ItemRuns,
+
+		LatestPlusOne,
+		Latest = LatestPlusOne - 1
+	};
+
+	static constexpr uint32 Magic = 0x45494E53;
+
+	/* Write the items to the end of the given buffer. Portable snapshots store the tag names, so they can be loaded after the tag table changes */
+	static void Write(TArray<uint8>& OutData, const FElementusItemSlots& InItems, const float InWeight, const float InValue,
+	                  const bool bPortable);
+
+	/* Read a snapshot written by Write. Returns false if the data is corrupted, of an unknown version or stores tag net indices of another tag table */
+	static bool Read(const TArray<uint8>& InData, FElementusInventorySnapshotData& OutSnapshot);
+};
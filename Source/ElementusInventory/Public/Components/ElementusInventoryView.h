@@ -0,0 +1,119 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include "Components/ElementusInventorySlots.h"
+
+/**
+ * Read-only range over the items of an inventory that match a predicate, without copying them.
+ * The predicate is evaluated once per run of identical items. It must not be used after the inventory is modified.
+ */
+template <typename PredicateType>
+class TElementusItemFilterView
+{
+public:
+	class FIterator
+	{
+	public:
+		FIterator(const FElementusItemSlots::FConstIterator& InSlot, const PredicateType* const InPredicate) : Slot(InSlot), Predicate(InPredicate)
+		{
+			SkipMismatches();
+		}
+
+		const FElementusItemInfo& operator*() const
+		{
+			return *Slot;
+		}
+
+		const FElementusItemInfo* operator->() const
+		{
+			return Slot.operator->();
+		}
+
+		FIterator& operator++()
+		{
+			const int32 RunIndex = Slot.GetRunIndex();
+			++Slot;
+
+			// The next slots of the same run hold the same item, so they still match
+			if (Slot.GetRunIndex() != RunIndex)
+			{
+				SkipMismatches();
+			}
+
+			return *this;
+		}
+
+		bool operator!=(const FIterator& Other) const
+		{
+			return Slot != Other.Slot;
+		}
+
+		explicit operator bool() const
+		{
+			return static_cast<bool>(Slot);
+		}
+
+		/* Slot of the current item in the inventory */
+		int32 GetIndex() const
+		{
+			return Slot.GetIndex();
+		}
+
+	private:
+		void SkipMismatches()
+		{
+			while (Slot && !(*Predicate)(*Slot))
+			{
+				Slot.SkipRun();
+			}
+		}
+
+		FElementusItemSlots::FConstIterator Slot;
+		const PredicateType* Predicate;
+	};
+
+	TElementusItemFilterView(const FElementusItemSlots& InItems, PredicateType InPredicate) : Items(&InItems), Predicate(MoveTemp(InPredicate))
+	{
+	}
+
+	FIterator begin() const
+	{
+		return FIterator(Items->begin(), &Predicate);
+	}
+
+	FIterator end() const
+	{
+		return FIterator(Items->end(), &Predicate);
+	}
+
+	bool IsEmpty() const
+	{
+		return !begin();
+	}
+
+	/* Count the matching items. Walks the whole view */
+	int32 Num() const
+	{
+		int32 Output = 0;
+		for (FIterator Iterator = begin(); Iterator; ++Iterator)
+		{
+			++Output;
+		}
+
+		return Output;
+	}
+
+private:
+	const FElementusItemSlots* Items;
+	PredicateType Predicate;
+};
+
+template <typename PredicateType>
+TElementusItemFilterView<PredicateType> MakeElementusItemFilterView(const FElementusItemSlots& InItems, PredicateType InPredicate)
+{
+	return TElementusItemFilterView<PredicateType>(InItems, MoveTemp(InPredicate));
+}
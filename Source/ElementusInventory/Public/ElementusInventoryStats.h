@@ -0,0 +1,57 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <Stats/Stats.h>
+#include <ProfilingDebugging/CpuProfilerTrace.h>
+#include <Trace/Trace.h>
+
+/**
+ * Use "stat ElementusInventory" to display the cycle counters (with their call counts) and the memory counters.
+ * On builds without stats, like headless Test servers, the same scopes are traced as events of the ElementusInventory channel in Unreal Insights.
+ */
+
+DECLARE_STATS_GROUP(TEXT("Elementus Inventory"), STATGROUP_ElementusInventory, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Add Items"), STAT_ElementusInventory_AddItems, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Remove Items"), STAT_ElementusInventory_RemoveItems, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Validate Trade"), STAT_ElementusInventory_ValidateTrade, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Trade Items"), STAT_ElementusInventory_TradeItems, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bulk Operations"), STAT_ElementusInventory_BulkOperations, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sort"), STAT_ElementusInventory_Sort, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find Items"), STAT_ElementusInventory_FindItems, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Validate Inventory"), STAT_ElementusInventory_ValidateInventory, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Definition Lookup"), STAT_ElementusInventory_DefinitionLookup, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Data Load"), STAT_ElementusInventory_ItemDataLoad, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("OnRep Items"), STAT_ElementusInventory_OnRepItems, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sync Replicated Items"), STAT_ElementusInventory_SyncReplicatedItems, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Snapshot Save"), STAT_ElementusInventory_SnapshotSave, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Snapshot Load"), STAT_ElementusInventory_SnapshotLoad, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Subsystem Flush"), STAT_ElementusInventory_SubsystemFlush, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Inventory Items"), STAT_ElementusInventory_ItemsMemory, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Replicated Items"), STAT_ElementusInventory_ReplicatedItemsMemory, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Subsystem Query Cache"), STAT_ElementusInventory_ItemPoolsMemory, STATGROUP_ElementusInventory, ELEMENTUSINVENTORY_API);
+
+UE_TRACE_CHANNEL_EXTERN(ElementusInventoryChannel, ELEMENTUSINVENTORY_API);
+
+/* Count and time the current scope with the given stat, also tracing it as an event of the ElementusInventory channel */
+#define ELEMENTUS_INVENTORY_SCOPE(StatName) \
+	SCOPE_CYCLE_COUNTER(STAT_ElementusInventory_##StatName); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("ElementusInventory_" #StatName, ElementusInventoryChannel)
+
+/* Report the change of an allocated size to the given memory stat */
+#define ELEMENTUS_INVENTORY_MEMORY_DELTA(StatName, Delta) \
+	do \
+	{ \
+		if (const int64 ElementusMemoryDelta = (Delta); ElementusMemoryDelta >= 0) \
+		{ \
+			INC_MEMORY_STAT_BY(STAT_ElementusInventory_##StatName, ElementusMemoryDelta); \
+		} \
+		else \
+		{ \
+			DEC_MEMORY_STAT_BY(STAT_ElementusInventory_##StatName, -ElementusMemoryDelta); \
+		} \
+	} while (0)
@@ -0,0 +1,22 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+/**
+ * Restricts the asset bundles that the inventory API loads in the current process, as configured in the inventory settings.
+ * Dedicated servers only need the "Data" and "Custom" bundles: "UI" and "SoftData" would load icons, images and soft classes for nothing.
+ */
+struct ELEMENTUSINVENTORY_API FElementusBundlePolicy
+{
+	/* Get the bundles of the request that the current process can load. Each disallowed bundle counts as a violation of the given call site */
+	static TArray<FName> FilterBundles(const TArray<FName>& InBundles, const FString& CallSite);
+
+	/* Num of disallowed bundles requested since the start or the last reset, even if they weren't filtered */
+	static int32 GetNumViolations();
+
+	static void ResetViolations();
+};
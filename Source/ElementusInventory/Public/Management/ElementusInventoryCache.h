@@ -0,0 +1,126 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <UObject/PrimaryAssetId.h>
+#include "Management/ElementusInventoryData.h"
+
+/**
+ * Resident and read-only cache of item definitions, keyed by the item primary asset id.
+ * Entries are populated once from the Asset Manager and kept after the item data is unloaded, so the inventory hot paths
+ * (weight, stackability, sorting, trading) become a table lookup instead of a LoadPrimaryAsset round-trip.
+ * Each id is also interned to a dense handle, which indexes the definitions directly.
+ * If the cooked item catalog is loaded, missing entries are read from it instead of the Asset Manager.
+ */
+class ELEMENTUSINVENTORY_API FElementusItemDefinitionCache
+{
+public:
+	static FElementusItemDefinitionCache& Get();
+
+	/**
+	 * Find the definition of the given item. A missing entry is read from the item catalog or, on the game thread, loaded through the Asset Manager.
+	 * Ids that fail to load are remembered as missing and aren't loaded again until they're registered, invalidated or the cache is reset.
+	 * Only the last MaxNumMissingIds missing ids are remembered, and they aren't interned
+	 */
+	bool FindDefinition(const FPrimaryAssetId& InItemId, FElementusItemDefinition& OutDefinition);
+
+	/* Find the definition of the given handle. On the game thread, a missing entry is loaded through the Asset Manager and cached */
+	bool FindDefinition(const FElementusItemHandle& InHandle, FElementusItemDefinition& OutDefinition);
+
+	/* Find the definition of the given item without loading anything. Safe to call from any thread */
+	bool FindCachedDefinition(const FPrimaryAssetId& InItemId, FElementusItemDefinition& OutDefinition) const;
+
+	/**
+	 * Does the given item have a cached definition, a definition in the item catalog or, without a catalog, an entry in the Asset Manager?
+	 * Nothing is loaded or interned, so it can check the ids received from clients before they reach FindDefinition
+	 */
+	bool IsKnownItemId(const FPrimaryAssetId& InItemId) const;
+
+	/* Find the definition of the given handle without loading anything. Safe to call from any thread */
+	bool FindCachedDefinition(const FElementusItemHandle& InHandle, FElementusItemDefinition& OutDefinition) const;
+
+	/* Get the handle of the given id, interning it if needed. Handles are kept until the module shuts down */
+	FElementusItemHandle InternItemId(const FPrimaryAssetId& InItemId);
+
+	/* Get the handle of the given id if it was already interned */
+	FElementusItemHandle FindItemHandle(const FPrimaryAssetId& InItemId) const;
+
+	/* Get the id of the given handle or an invalid id if the handle wasn't interned */
+	FPrimaryAssetId ResolveItemHandle(const FElementusItemHandle& InHandle) const;
+
+	/* Cache the definitions of all items of the item catalog or, if it isn't loaded, of all registered elementus items in a single request */
+	void PreloadAllDefinitions();
+
+	/* Add or replace the cached definition of the given item data */
+	void RegisterItemData(const UElementusItemData* InItemData);
+
+	/* Add or replace the cached definition of the given item */
+	void RegisterDefinition(const FPrimaryAssetId& InItemId, const FElementusItemDefinition& InDefinition);
+
+	/* Remove the cached definition or the missing mark of the given item, it will be loaded again in the next request */
+	void Invalidate(const FPrimaryAssetId& InItemId);
+
+	/* Remove all cached definitions and missing marks. Interned handles and the catalog hash stay valid */
+	void Reset();
+
+	int32 Num() const;
+
+	/**
+	 * Hash of the item ids and their stackability, stable between processes. Computed from the item catalog or the ids registered in the Asset Manager,
+	 * and zero (unknown) until then or after a definition that it doesn't cover is registered.
+	 * Inventory snapshots saved with the current hash don't need to be validated again
+	 */
+	uint32 GetCatalogHash() const;
+
+	/**
+	 * Compute the catalog hash from the item ids registered in the Asset Manager, without loading the item data. The stackability is read from the
+	 * cached definitions or the asset registry tags
+	 */
+	void UpdateCatalogHashFromAssetManager();
+
+private:
+	FElementusItemDefinitionCache() = default;
+
+	FElementusItemHandle InternItemId_Locked(const FPrimaryAssetId& InItemId);
+
+	/* Max num of ids remembered as missing. Past it, the oldest ones are forgotten and may be loaded again */
+	static constexpr int32 MaxNumMissingIds = 1024;
+
+	void UpdateCatalogHash(const TArray<FPrimaryAssetId>& InItemIds);
+
+	bool IsMarkedMissing(const FPrimaryAssetId& InItemId) const;
+	void MarkMissing(const FPrimaryAssetId& InItemId);
+
+	mutable FRWLock DefinitionsLock;
+
+	TMap<FPrimaryAssetId, FElementusItemHandle> HandlesById;
+	TArray<FPrimaryAssetId> IdsByHandle;
+
+	/* Indexed by handle, only the entries set in CachedDefinitions are valid */
+	TArray<FElementusItemDefinition> Definitions;
+	TBitArray<> CachedDefinitions;
+
+	/* Ids without a definition in the catalog or the Asset Manager, kept apart from the handles so unknown ids aren't interned forever */
+	TSet<FPrimaryAssetId> MissingIds;
+
+	/* Ring of the ids in MissingIds, from the oldest at NextMissingId once it's full */
+	TArray<FPrimaryAssetId> MissingIdsOrder;
+	int32 NextMissingId = 0;
+
+	/* How each item was included in the catalog hash */
+	enum class EHashedItem : uint8
+	{
+		None,
+		UnknownStackability,
+		Stackable,
+		NotStackable
+	};
+
+	/* Indexed by handle */
+	TArray<EHashedItem> HashedItems;
+
+	uint32 CatalogHash = 0u;
+};
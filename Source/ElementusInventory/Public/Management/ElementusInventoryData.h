@@ -10,6 +10,7 @@
 #include "ElementusInventoryData.generated.h"
 
 class UTexture2D;
+class UPackageMap;
 
 constexpr auto ElementusItemDataType = TEXT("ElementusInventory_ItemData");
 
@@ -52,13 +53,66 @@ struct FPrimaryElementusItemId : public FPrimaryAssetId
 
 	bool operator>(const FPrimaryElementusItemId& Other) const
 	{
-		return ToString() > Other.ToString();
+		return Other < *this;
 	}
 
-	bool operator<(const FPrimaryElementusItemId& Other) const
+	/* Same order as comparing the "Type:Name" strings, without allocating them: numbered names like "Item_10" come before "Item_2" */
+	ELEMENTUSINVENTORY_API bool operator<(const FPrimaryElementusItemId& Other) const;
+
+	/* Get the numeric id of catalog items ("Item_<ItemId>") without converting the name to a string */
+	ELEMENTUSINVENTORY_API bool GetCatalogItemId(uint32& OutItemId) const;
+
+	ELEMENTUSINVENTORY_API static FPrimaryElementusItemId MakeCatalogItemId(const uint32 InItemId);
+};
+
+/**
+ * Compact id of an item, interned by the item definition cache. Handles follow the interning order of each process, so they're only valid in the
+ * current session: use FPrimaryElementusItemId to save or replicate ids, whose catalog number is the same in every process
+ */
+USTRUCT(BlueprintType, Category = "Elementus Inventory | Structs")
+struct FElementusItemHandle
+{
+	GENERATED_BODY()
+
+	FElementusItemHandle() = default;
+
+	explicit FElementusItemHandle(const int32 InIndex) : Index(InIndex)
+	{
+	}
+
+	bool IsValid() const
+	{
+		return Index != INDEX_NONE;
+	}
+
+	int32 GetIndex() const
+	{
+		return Index;
+	}
+
+	bool operator==(const FElementusItemHandle& Other) const
+	{
+		return Index == Other.Index;
+	}
+
+	bool operator!=(const FElementusItemHandle& Other) const
+	{
+		return Index != Other.Index;
+	}
+
+	bool operator<(const FElementusItemHandle& Other) const
+	{
+		return Index < Other.Index;
+	}
+
+	friend uint32 GetTypeHash(const FElementusItemHandle& InHandle)
 	{
-		return ToString() < Other.ToString();
+		return ::GetTypeHash(InHandle.Index);
 	}
+
+private:
+	UPROPERTY()
+	int32 Index = INDEX_NONE;
 };
 
 USTRUCT(BlueprintType, Category = "Elementus Inventory | Structs")
@@ -104,9 +158,24 @@ struct FElementusItemInfo
 
 	bool operator<(const FElementusItemInfo& Other) const
 	{
-		return ItemId.ToString() < Other.ItemId.ToString();
+		return ItemId < Other.ItemId;
 	}
 
+	/**
+	 * Compact wire format: catalog ids ("Item_<ItemId>") are sent as their numeric id, level and quantity as variable-length integers
+	 * and tags by their net index. Other ids fall back to their names
+	 */
+	ELEMENTUSINVENTORY_API bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	/**
+	 * Byte-aligned variant of the compact format used by the inventory snapshots. Tag net indices are only stable while the tag table doesn't change,
+	 * so portable snapshots store the tag names instead
+	 */
+	void SaveSnapshot(FArchive& Ar, const bool bTagsByName) const;
+
+	/* Read an item written by SaveSnapshot */
+	void LoadSnapshot(FArchive& Ar, const bool bTagsByName);
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elementus Inventory")
 	FPrimaryElementusItemId ItemId;
 
@@ -120,6 +189,40 @@ struct FElementusItemInfo
 	FGameplayTagContainer Tags;
 };
 
+template <>
+struct TStructOpsTypeTraits<FElementusItemInfo> : public TStructOpsTypeTraitsBase2<FElementusItemInfo>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/* Read-only subset of the item data used by the inventory hot paths, kept resident by the item definition cache */
+USTRUCT(BlueprintType, Category = "Elementus Inventory | Structs")
+struct FElementusItemDefinition
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Elementus Inventory")
+	int32 ItemId = INDEX_NONE;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Elementus Inventory")
+	FName ItemName = NAME_None;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Elementus Inventory")
+	EElementusItemType ItemType = EElementusItemType::None;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Elementus Inventory")
+	bool bIsStackable = true;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Elementus Inventory")
+	float ItemValue = 0.f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Elementus Inventory")
+	float ItemWeight = 0.f;
+};
+
 UCLASS(NotBlueprintable, NotPlaceable, Category = "Elementus Inventory | Classes | Data")
 class ELEMENTUSINVENTORY_API UElementusItemData final : public UPrimaryDataAsset
 {
@@ -133,6 +236,13 @@ public:
 		return FPrimaryAssetId(TEXT("ElementusInventory_ItemData"), *("Item_" + FString::FromInt(ItemId)));
 	}
 
+	/* Build the read-only definition that is stored in the item definition cache */
+	FElementusItemDefinition MakeItemDefinition() const;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Elementus Inventory", meta = (AssetBundles = "Data"))
 	int32 ItemId;
 
@@ -151,7 +261,8 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Elementus Inventory", meta = (AssetBundles = "Data"))
 	EElementusItemType ItemType;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Elementus Inventory", meta = (AssetBundles = "Data"))
+	/* Searchable in the asset registry, so the catalog hash can include it without loading the item data */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, AssetRegistrySearchable, Category = "Elementus Inventory", meta = (AssetBundles = "Data"))
 	bool bIsStackable = true;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Elementus Inventory", meta = (UIMin = 0, ClampMin = 0, AssetBundles = "Data"))
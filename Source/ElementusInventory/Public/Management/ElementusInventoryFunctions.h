@@ -7,6 +7,7 @@
 #include <CoreMinimal.h>
 #include <Kismet/BlueprintFunctionLibrary.h>
 #include <Runtime/Launch/Resources/Version.h>
+#include "Management/ElementusInventoryData.h"
 #include "ElementusInventoryFunctions.generated.h"
 
 UENUM(BlueprintType, Category = "Elementus Inventory | Enumerations")
@@ -17,10 +18,52 @@ enum class EElementusSearchType : uint8
 	Type
 };
 
+UENUM(BlueprintType, Category = "Elementus Inventory | Enumerations")
+enum class EElementusTradeItemResult : uint8
+{
+	Accepted,
+	InvalidItem,
+	MissingDefinition,
+	NotEnoughQuantity,
+	NotEnoughSlots,
+	ExceedsMaxWeight,
+	Cancelled
+};
+
+UENUM(BlueprintType, Category = "Elementus Inventory | Enumerations")
+enum class EElementusBulkOperationType : uint8
+{
+	AddItems,
+	DiscardItems,
+	ClearInventory
+};
+
 class UElementusInventoryComponent;
+
+/* Operation applied to an inventory by ApplyBulkOperations */
+USTRUCT(BlueprintType, Category = "Elementus Inventory | Structs")
+struct FElementusBulkInventoryOperation
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elementus Inventory")
+	UElementusInventoryComponent* Inventory = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elementus Inventory")
+	EElementusBulkOperationType Operation = EElementusBulkOperationType::AddItems;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Elementus Inventory")
+	TArray<FElementusItemInfo> Items;
+};
+
 class UAssetManager;
 class UElementusItemData;
 struct FPrimaryElementusItemId;
+struct FElementusItemDefinition;
+struct FElementusItemHandle;
+struct FStreamableHandle;
+
+DECLARE_DELEGATE_OneParam(FElementusItemDataArrayLoaded, const TArray<UElementusItemData*>&);
 
 /**
  *
@@ -62,6 +105,41 @@ public:
 	static TArray<UElementusItemData*> SearchElementusItemData(const EElementusSearchType SearchType, const FString& SearchString,
 	                                                           const TArray<FName>& InBundles, const bool bAutoUnload = true);
 
+	/**
+	 * Load the item datas of the given ids in a single streamable handle and call OnLoaded on the game thread once they're available, without blocking
+	 * Unload them with UnloadElementusItem when they're no longer needed. Returns the handle, which is invalid if the items were already loaded
+	 */
+	static TSharedPtr<FStreamableHandle> LoadItemDataArrayAsync(const TArray<FPrimaryElementusItemId>& InIDs, const TArray<FName>& InBundles,
+	                                                            FElementusItemDataArrayLoaded OnLoaded);
+
+	/* Asynchronous version of SearchElementusItemData: all registered items are loaded in a single streamable handle and filtered once available */
+	static TSharedPtr<FStreamableHandle> SearchElementusItemDataAsync(const EElementusSearchType SearchType, const FString& SearchString,
+	                                                                  const TArray<FName>& InBundles, FElementusItemDataArrayLoaded OnLoaded);
+
+	/* Return the cached definition (weight, value, type, stackability) of the given id, loading it only on the first request */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	static bool GetItemDefinitionById(const FPrimaryElementusItemId& InID, FElementusItemDefinition& OutDefinition);
+
+	/* Load the definitions of all registered elementus items at once to avoid loads during gameplay */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	static void PreloadItemDefinitions();
+
+	/* Get the num of bundles requested through the inventory API that the current process isn't allowed to load, see the bundle policy settings */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	static int32 GetNumBundlePolicyViolations();
+
+	/* Remove all cached item definitions and missing ids, they will be loaded again in the next request */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	static void ResetItemDefinitionCache();
+
+	/* Get the compact handle of the given id. Handles are only valid in the current session */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	static FElementusItemHandle GetItemHandleById(const FPrimaryElementusItemId& InID);
+
+	/* Get the id of the given handle */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	static FPrimaryElementusItemId GetItemIdByHandle(const FElementusItemHandle& InHandle);
+
 	/* Get the primary asset ids of all registered elementus items */
 	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
 	static TArray<FPrimaryAssetId> GetAllElementusItemIds();
@@ -120,9 +198,35 @@ private:
 	static TArray<UElementusItemData*> LoadElementusItemDatas_Internal(UAssetManager* InAssetManager, const TArray<FPrimaryElementusItemId>& InIDs,
 	                                                                   const TArray<FName>& InBundles, const bool bAutoUnload);
 
+	static TSharedPtr<FStreamableHandle> LoadElementusItemDatasAsync_Internal(const TArray<FPrimaryAssetId>& InIDs, const TArray<FName>& InBundles,
+	                                                                          TFunction<void(TArray<UElementusItemData*>&&)>&& OnLoaded);
+
+	static bool MatchesSearch(const UElementusItemData* InItemData, const EElementusSearchType SearchType, const FString& SearchString);
+
 public:
 	/* Filter the container and return only items that can be traded at the current context */
 	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
 	static TArray<FElementusItemInfo> FilterTradeableItems(UElementusInventoryComponent* FromInventory, UElementusInventoryComponent* ToInventory,
 	                                                       const TArray<FElementusItemInfo>& Items);
+
+	/* Check each item against the state both inventories would have after the previous items were traded. Returns the num of accepted items */
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	static int32 ValidateTrade(UElementusInventoryComponent* FromInventory, UElementusInventoryComponent* ToInventory,
+	                           const TArray<FElementusItemInfo>& Items, TArray<EElementusTradeItemResult>& OutResults);
+
+	/**
+	 * Move the accepted items between both inventories, with a single update per inventory. Authority only
+	 * If bRequireAllItems is true, nothing is traded unless all items are accepted. Returns true if any item was traded
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	static bool TradeItems(UElementusInventoryComponent* FromInventory, UElementusInventoryComponent* ToInventory, const TArray<FElementusItemInfo>& Items,
+	                       TArray<EElementusTradeItemResult>& OutResults, const bool bRequireAllItems = false);
+
+	/**
+	 * Apply the operations to many inventories at once. Authority only
+	 * Operations are validated in parallel, one task per inventory, and each inventory is then updated and notified once on the game thread
+	 * Items that don't fit (weight, slots) or that aren't available are skipped. Returns the num of accepted items of each operation
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	static TArray<int32> ApplyBulkOperations(const TArray<FElementusBulkInventoryOperation>& Operations);
 };
@@ -8,6 +8,19 @@
 #include <Engine/DeveloperSettings.h>
 #include "ElementusInventorySettings.generated.h"
 
+UENUM(BlueprintType, Category = "Elementus Inventory | Enumerations")
+enum class EElementusBundlePolicyMode : uint8
+{
+	/* Load all requested bundles */
+	Disabled,
+
+	/* Load all requested bundles, but count and log the disallowed ones */
+	Report,
+
+	/* Ignore the disallowed bundles, counting and logging them */
+	Enforce
+};
+
 /**
  *
  */
@@ -24,10 +37,55 @@ public:
 	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Settings", Meta = (DisplayName = "Enable Internal Logs"))
 	bool bEnableInternalLogs;
 
+	/* Number of inventory mutations between full weight recomputations used to detect drift of the incremental weight. 0 disables the check. Ignored in shipping builds */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Settings", Meta = (DisplayName = "Weight Validation Interval", ClampMin = "0", UIMin = "0"))
+	int32 WeightValidationInterval;
+
+	/* Serve the item definitions and relations from the cooked item catalog on dedicated servers, without loading the item datas */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Settings", Meta = (DisplayName = "Use Cooked Item Catalog On Dedicated Servers"))
+	bool bUseCookedItemCatalog;
+
+	/**
+	 * Path of the item catalog written by the ElementusItemCatalog commandlet, relative to the project content directory
+	 * Add its directory to "Additional Non-Asset Directories To Copy" in the packaging settings to stage it
+	 */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Settings", Meta = (DisplayName = "Cooked Item Catalog Path", EditCondition = "bUseCookedItemCatalog"))
+	FString CookedItemCatalogPath;
+
+	/* Get the absolute path of the cooked item catalog */
+	FString GetCookedItemCatalogFilePath() const;
+
+	/**
+	 * Default of bReplicateItemsToOwnerOnly in new inventory components: replicate the items only to the owning connection, and a summary to the
+	 * other connections. Packages with this option replicate their items to the players that opened them
+	 */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Settings", Meta = (DisplayName = "Replicate Items To Owner Only"))
+	bool bReplicateItemsToOwnerOnly;
+
+	/* Max distance between the owners of two inventories for a client to trade between them, unless both are owned by its connection. 0 disables the distance check */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Settings", Meta = (DisplayName = "Max Client Interaction Distance", ClampMin = "0", UIMin = "0"))
+	float MaxClientInteractionDistance;
+
+	/* How the bundles requested through the inventory API are restricted on dedicated servers */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Bundle Policy", Meta = (DisplayName = "Dedicated Server Bundle Policy"))
+	EElementusBundlePolicyMode DedicatedServerBundlePolicy;
+
+	/* Bundles that dedicated servers can load. The default "Data" and "Custom" bundles hold all fields used by the gameplay */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Bundle Policy", Meta = (DisplayName = "Dedicated Server Allowed Bundles"))
+	TArray<FName> DedicatedServerAllowedBundles;
+
 	/* Experimental parameter to assist using empty slots in the inventory: If true, will replace empty slots with empty item info */
 	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Default Values | Inventory Component", Meta = (DisplayName = "Allow Empty Slots"))
 	bool bAllowEmptySlots;
 
+	/* Keep a lookup table from item id to slots in the inventory. Can be disabled for tiny inventories where a linear search is cheaper */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Default Values | Inventory Component", Meta = (DisplayName = "Enable Item Indexing"))
+	bool bEnableItemIndexing;
+
+	/* Store and replicate consecutive identical items, like expanded non-stackable items, as a single run */
+	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Default Values | Inventory Component", Meta = (DisplayName = "Compact Item Runs"))
+	bool bCompactItemRuns;
+
 	/* Max weight allowed for this inventory */
 	UPROPERTY(GlobalConfig, EditAnywhere, Category = "Default Values | Inventory Component",
 		meta = (DisplayName = "Max Weight", ClampMin = "0", UIMin = "0"))
@@ -0,0 +1,99 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Subsystems/WorldSubsystem.h>
+#include <UObject/ObjectKey.h>
+#include "Management/ElementusInventoryData.h"
+#include "ElementusInventorySubsystem.generated.h"
+
+class UElementusInventoryComponent;
+
+/**
+ * Cached copy of the items of all registered inventories, stored as parallel arrays so the world-wide queries stream through contiguous memory.
+ * Each inventory owns a range of the pools, with one entry per run of identical items. Unused entries have an invalid owner and item handle
+ */
+struct ELEMENTUSINVENTORY_API FElementusInventoryItemPools
+{
+	/* Index of the owning inventory record, INDEX_NONE for unused entries */
+	TArray<int32> Owners;
+
+	/* Interned item ids, see FElementusItemDefinitionCache::InternItemId */
+	TArray<FElementusItemHandle> ItemHandles;
+
+	/* Total quantity of the slots of each run. Only the columns read by the queries are cached */
+	TArray<int32> Quantities;
+
+	int32 Num() const
+	{
+		return Owners.Num();
+	}
+};
+
+/* Range of the item pools used by a registered inventory */
+struct FElementusInventoryRecord
+{
+	TWeakObjectPtr<UElementusInventoryComponent> Inventory;
+	int32 Offset = 0;
+	int32 Num = 0;
+	int32 Capacity = 0;
+	bool bIsDirty = false;
+};
+
+/**
+ * Answers world-wide item queries from a structure-of-arrays cache of all authoritative inventories of the world.
+ * The items are stored by the components: the cache is a second copy, refreshed before each query from the inventories marked as dirty
+ */
+UCLASS(Category = "Elementus Inventory | Classes")
+class ELEMENTUSINVENTORY_API UElementusInventorySubsystem final : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UElementusInventorySubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Deinitialize() override;
+
+	void RegisterInventory(UElementusInventoryComponent* Inventory);
+	void UnregisterInventory(UElementusInventoryComponent* Inventory);
+
+	/* Schedule the cached items of the given inventory to be refreshed before the next query */
+	void MarkInventoryDirty(UElementusInventoryComponent* Inventory);
+
+	/* Get all inventories of the world that have the given item */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	TArray<UElementusInventoryComponent*> GetInventoriesWithItem(const FPrimaryElementusItemId& InItemId);
+
+	/* Get the total quantity of the given item in all inventories of the world */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	int64 GetWorldItemQuantity(const FPrimaryElementusItemId& InItemId);
+
+	UFUNCTION(BlueprintPure, Category = "Elementus Inventory")
+	TArray<UElementusInventoryComponent*> GetRegisteredInventories() const;
+
+private:
+	/* Get the inventory that owns the given record of the item pools */
+	UElementusInventoryComponent* GetRecordInventory(const int32 RecordIndex) const;
+
+	void FlushDirtyInventories();
+	void WriteRecord(const int32 RecordIndex);
+	void ReleaseRecordRange(FElementusInventoryRecord& Record);
+	void CompactPools();
+	void UpdateMemoryStats();
+
+	FElementusInventoryItemPools Pools;
+	int32 NumUnusedPoolEntries = 0;
+
+#if STATS
+	/* Allocated size of the pools last reported to the memory stats */
+	int64 ReportedPoolsMemory = 0;
+#endif
+
+	TArray<FElementusInventoryRecord> Records;
+	TArray<int32> FreeRecords;
+	TArray<int32> DirtyRecords;
+	TMap<TObjectKey<UElementusInventoryComponent>, int32> RecordsByInventory;
+};
@@ -0,0 +1,69 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <UObject/PrimaryAssetId.h>
+#include "Management/ElementusInventoryData.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Flat binary table with the fields of all item datas that are used by the server: id, name, type, stackability, value, weight and relations.
+ * It's cooked by the ElementusItemCatalog commandlet and mapped in memory as is, so the definitions are served without loading any item data.
+ */
+class ELEMENTUSINVENTORY_API FElementusItemCatalog
+{
+public:
+	static FElementusItemCatalog& Get();
+
+	~FElementusItemCatalog();
+
+	/* Max num of relations of a single item in the table */
+	static constexpr int32 MaxNumRelations = MAX_uint16;
+
+	/* Build the table from the given item datas. Items with a negative or duplicated id, or with more than MaxNumRelations relations, are skipped */
+	static void Build(const TArray<UElementusItemData*>& InItemDatas, TArray<uint8>& OutData);
+
+	/* Map the given file and use it as the item catalog. Returns false if the file is missing or invalid */
+	bool Load(const FString& InFilePath);
+
+	void Unload();
+
+	bool IsLoaded() const;
+
+	int32 Num() const;
+
+	/* Find the definition of the given item in the table. Safe to call from any thread */
+	bool FindDefinition(const FPrimaryAssetId& InItemId, FElementusItemDefinition& OutDefinition) const;
+
+	/* Find the relations of the given item in the table */
+	bool FindRelations(const FPrimaryAssetId& InItemId, TMap<FGameplayTag, FPrimaryElementusItemIdContainer>& OutRelations) const;
+
+	/* Call the given function with the id and the definition of each item in the table */
+	void ForEachDefinition(TFunctionRef<void(const FPrimaryAssetId&, const FElementusItemDefinition&)> InFunction) const;
+
+private:
+	FElementusItemCatalog() = default;
+
+	/* Check the table layout before using it: offsets and counts must stay within the data */
+	bool ValidateData() const;
+
+	int32 FindItemIndex(const FPrimaryAssetId& InItemId) const;
+
+	FElementusItemDefinition MakeDefinition(const int32 InItemIndex) const;
+
+	FName GetName(const uint32 InOffset) const;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/* Used when the platform can't map the file */
+	TArray<uint8> LoadedData;
+
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+};
@@ -0,0 +1,72 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Kismet/BlueprintAsyncActionBase.h>
+#include "Management/ElementusInventoryFunctions.h"
+#include "ElementusItemDataAsyncLoad.generated.h"
+
+class UElementusInventoryComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FElementusItemDataAsyncLoadDelegate, const TArray<UElementusItemData*>&, ItemDatas);
+
+/**
+ * Latent nodes that load item datas without blocking the game thread. All ids of a node are loaded in a single streamable handle
+ * Loaded item datas stay in memory until they're unloaded with UnloadElementusItem
+ */
+UCLASS(NotPlaceable, Category = "Elementus Inventory | Classes")
+class ELEMENTUSINVENTORY_API UElementusItemDataAsyncLoad final : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	/* Called when the item datas are available */
+	UPROPERTY(BlueprintAssignable, Category = "Elementus Inventory")
+	FElementusItemDataAsyncLoadDelegate OnLoaded;
+
+	/* Called when none of the item datas could be loaded. Searches without matches call OnLoaded with an empty array instead */
+	UPROPERTY(BlueprintAssignable, Category = "Elementus Inventory")
+	FElementusItemDataAsyncLoadDelegate OnFailed;
+
+	/* Load the item datas of the given ids */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory",
+		meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Load Item Data Array Async"))
+	static UElementusItemDataAsyncLoad* LoadItemDataArrayAsync(UObject* WorldContextObject, const TArray<FPrimaryElementusItemId>& InIDs,
+	                                                           const TArray<FName>& InBundles);
+
+	/* Load the item datas of all items in the given inventory, e.g. with the "UI" bundle to display its icons */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory",
+		meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Load Inventory Item Data Async"))
+	static UElementusItemDataAsyncLoad* LoadInventoryItemDataAsync(UObject* WorldContextObject, const UElementusInventoryComponent* Inventory,
+	                                                               const TArray<FName>& InBundles);
+
+	/* Search all registered elementus items and return the item datas that match the given parameters */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory",
+		meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Search Elementus Item Data Async"))
+	static UElementusItemDataAsyncLoad* SearchElementusItemDataAsync(UObject* WorldContextObject, const EElementusSearchType SearchType,
+	                                                                 const FString& SearchString, const TArray<FName>& InBundles);
+
+	virtual void Activate() override;
+
+	/* Stop waiting for the item datas. The delegates won't be called */
+	UFUNCTION(BlueprintCallable, Category = "Elementus Inventory")
+	void Cancel();
+
+private:
+	static UElementusItemDataAsyncLoad* CreateTask(UObject* WorldContextObject, const TArray<FName>& InBundles);
+
+	void OnItemDatasLoaded(const TArray<UElementusItemData*>& ItemDatas);
+
+	TArray<FPrimaryElementusItemId> ItemIds;
+	TArray<FName> Bundles;
+
+	bool bIsSearch = false;
+	bool bHasCompleted = false;
+	EElementusSearchType SearchType = EElementusSearchType::Name;
+	FString SearchString;
+
+	TSharedPtr<FStreamableHandle> StreamableHandle;
+};
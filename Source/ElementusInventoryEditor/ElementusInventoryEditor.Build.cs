@@ -30,7 +30,8 @@ public class ElementusInventoryEditor : ModuleRules
 			"EditorStyle",
 			"WorkspaceMenuStructure",
 			"PropertyEditor",
-			"GameplayTags"
+			"GameplayTags",
+			"AssetRegistry"
 		});
 	}
 }
\ No newline at end of file
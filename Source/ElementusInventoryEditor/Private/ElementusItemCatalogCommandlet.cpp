@@ -0,0 +1,77 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "ElementusItemCatalogCommandlet.h"
+#include <Management/ElementusInventoryFunctions.h>
+#include <Management/ElementusInventorySettings.h>
+#include <Management/ElementusItemCatalog.h>
+#include <Engine/AssetManager.h>
+#include <AssetRegistry/AssetRegistryModule.h>
+#include <Misc/FileHelper.h>
+
+#ifdef UE_INLINE_GENERATED_CPP_BY_NAME
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ElementusItemCatalogCommandlet)
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogElementusItemCatalog, Display, All);
+
+UElementusItemCatalogCommandlet::UElementusItemCatalogCommandlet(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UElementusItemCatalogCommandlet::Main(const FString& Params)
+{
+	FString OutputPath;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		OutputPath = UElementusInventorySettings::Get()->GetCookedItemCatalogFilePath();
+	}
+
+	// Commandlets don't wait for the asset registry: the Asset Manager must scan again once all assets are known
+	FAssetRegistryModule::GetRegistry().SearchAllAssets(true);
+	UAssetManager::Get().ReinitializeFromConfig();
+
+	const TArray<FPrimaryAssetId> AllIds = UElementusInventoryFunctions::GetAllElementusItemIds();
+
+	TArray<UElementusItemData*> ItemDatas;
+	ItemDatas.Reserve(AllIds.Num());
+
+	for (const FPrimaryAssetId& Iterator : AllIds)
+	{
+		UElementusItemData* const ItemData = Cast<UElementusItemData>(UAssetManager::Get().GetPrimaryAssetPath(Iterator).TryLoad());
+		if (!ItemData)
+		{
+			UE_LOG(LogElementusItemCatalog, Warning, TEXT("%s: Failed to load the item data %s"), *FString(__FUNCTION__), *Iterator.ToString());
+			continue;
+		}
+
+		// The catalog stores the num of relations of each item in 16 bits
+		if (ItemData->Relations.Num() > FElementusItemCatalog::MaxNumRelations)
+		{
+			UE_LOG(LogElementusItemCatalog, Error, TEXT("%s: Item data %s has %d relations, more than the max of %d, and was rejected"),
+			       *FString(__FUNCTION__), *Iterator.ToString(), ItemData->Relations.Num(), FElementusItemCatalog::MaxNumRelations);
+			continue;
+		}
+
+		ItemDatas.Add(ItemData);
+	}
+
+	TArray<uint8> CatalogData;
+	FElementusItemCatalog::Build(ItemDatas, CatalogData);
+
+	if (!FFileHelper::SaveArrayToFile(CatalogData, *OutputPath))
+	{
+		UE_LOG(LogElementusItemCatalog, Error, TEXT("%s: Failed to write the item catalog to %s"), *FString(__FUNCTION__), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogElementusItemCatalog, Display, TEXT("%s: Wrote %d items (%d bytes) to %s"), *FString(__FUNCTION__), ItemDatas.Num(), CatalogData.Num(),
+	       *OutputPath);
+
+	return 0;
+}
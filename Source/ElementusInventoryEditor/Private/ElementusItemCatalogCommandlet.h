@@ -0,0 +1,24 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Commandlets/Commandlet.h>
+#include "ElementusItemCatalogCommandlet.generated.h"
+
+/**
+ * Bake all registered item datas into the flat item catalog used by dedicated servers
+ * Usage: -run=ElementusItemCatalog [-Output=<Path>]. The default output is the catalog path of the inventory settings
+ */
+UCLASS()
+class UElementusItemCatalogCommandlet final : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	explicit UElementusItemCatalogCommandlet(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -12,14 +12,15 @@ struct FElementusItemRowData
 {
 	explicit FElementusItemRowData(const FPrimaryElementusItemId& InPrimaryAssetId)
 	{
-		const auto ItemData = UElementusInventoryFunctions::GetSingleItemDataById(InPrimaryAssetId, {TEXT("Data"), TEXT("SoftData"),}, false);
+		const auto ItemData = UElementusInventoryFunctions::GetSingleItemDataById(InPrimaryAssetId, {TEXT("Data"),}, false);
 
 		PrimaryAssetId = InPrimaryAssetId;
 		Id = ItemData->ItemId;
 		Name = ItemData->ItemName;
 		Type = ItemData->ItemType;
-		Class = ItemData->ItemClass.IsValid() ? *ItemData->ItemClass.LoadSynchronous()->GetName() : FName();
-		Object = ItemData->ItemObject.IsValid() ? *ItemData->ItemObject.LoadSynchronous()->GetName() : FName();
+		// Only the names are displayed: the soft references don't need to be loaded
+		Class = ItemData->ItemClass.IsNull() ? FName() : FName(*ItemData->ItemClass.GetAssetName());
+		Object = ItemData->ItemObject.IsNull() ? FName() : FName(*ItemData->ItemObject.GetAssetName());
 		Value = ItemData->ItemValue;
 		Weight = ItemData->ItemWeight;
 
@@ -80,6 +80,7 @@ FReply SElementusUtils::OnButtonClicked(const uint32 ButtonId) const
 
 			if (ObjectTools::DeleteAssets(AssetsToDelete) > 0)
 			{
+				UElementusInventoryFunctions::ResetItemDefinitionCache();
 				TableSource->UpdateItemList();
 			}
 		}
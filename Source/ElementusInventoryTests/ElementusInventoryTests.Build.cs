@@ -0,0 +1,30 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+using UnrealBuildTool;
+
+public class ElementusInventoryTests : ModuleRules
+{
+	public ElementusInventoryTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+		CppStandard = CppStandardVersion.Cpp17;
+
+		PublicDependencyModuleNames.AddRange(new[]
+		{
+			"Core"
+		});
+
+		PrivateDependencyModuleNames.AddRange(new[]
+		{
+			"ElementusInventory",
+			"CoreUObject",
+			"Engine",
+			"NetCore",
+			"GameplayTags",
+			"Json",
+			"Projects"
+		});
+	}
+}
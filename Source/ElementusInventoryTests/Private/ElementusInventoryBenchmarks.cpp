@@ -0,0 +1,639 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "ElementusInventoryTestCatalog.h"
+#include "Management/ElementusInventoryCache.h"
+#include "Components/ElementusInventoryComponent.h"
+#include "LogElementusInventoryTests.h"
+#include <GameplayTagsManager.h>
+#include <HAL/IConsoleManager.h>
+#include <UObject/CoreNet.h>
+#include <Engine/World.h>
+#include <Interfaces/IPluginManager.h>
+#include <Dom/JsonObject.h>
+#include <Serialization/JsonSerializer.h>
+#include <Serialization/JsonWriter.h>
+#include <Misc/AutomationTest.h>
+#include <Misc/EngineVersion.h>
+#include <Misc/App.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+
+#if !UE_BUILD_SHIPPING
+/* Size of the item with the default property replication: both id names, two full integers and the tag container */
+static int64 GetPropertyWireSize(FElementusItemInfo InItemInfo)
+{
+	FNetBitWriter Writer(nullptr, 0);
+
+	FName TypeName = InItemInfo.ItemId.PrimaryAssetType.GetName();
+	UPackageMap::StaticSerializeName(Writer, TypeName);
+	UPackageMap::StaticSerializeName(Writer, InItemInfo.ItemId.PrimaryAssetName);
+	Writer << InItemInfo.Level;
+	Writer << InItemInfo.Quantity;
+
+	bool bSuccess = true;
+	InItemInfo.Tags.NetSerialize(Writer, nullptr, bSuccess);
+
+	return Writer.GetNumBits();
+}
+
+static int64 GetCompactWireSize(FElementusItemInfo InItemInfo)
+{
+	FNetBitWriter Writer(nullptr, 0);
+
+	bool bSuccess = true;
+	InItemInfo.NetSerialize(Writer, nullptr, bSuccess);
+
+	return Writer.GetNumBits();
+}
+
+static void LogItemWireSize(const TCHAR* Label, const FElementusItemInfo& InItemInfo)
+{
+	const int64 PropertyBits = GetPropertyWireSize(InItemInfo);
+	const int64 CompactBits = GetCompactWireSize(InItemInfo);
+
+	UE_LOG(LogElementusInventoryTests, Display, TEXT("%s: %s item - property: %lld bytes, compact: %lld bytes (%.1f%%)"), *FString(__FUNCTION__), Label,
+	       FMath::DivideAndRoundUp<int64>(PropertyBits, 8), FMath::DivideAndRoundUp<int64>(CompactBits, 8),
+	       PropertyBits > 0 ? 100.0 * CompactBits / PropertyBits : 0.0);
+}
+
+static void RunItemNetSizeBenchmark()
+{
+	FGameplayTagContainer AllTags;
+	UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, true);
+
+	// Typical: a catalog item with the default level and a single tag
+	FElementusItemInfo TypicalItem(FPrimaryElementusItemId(FPrimaryAssetId(ElementusItemDataType, TEXT("Item_42"))), 3);
+	if (!AllTags.IsEmpty())
+	{
+		TypicalItem.Tags.AddTag(AllTags.GetByIndex(0));
+	}
+
+	// Worst case: an id outside of the catalog, large level and quantity and several tags
+	FElementusItemInfo WorstItem(FPrimaryElementusItemId(FPrimaryAssetId(TEXT("CustomItemType"), TEXT("CustomItemWithALongName"))), MAX_int32);
+	WorstItem.Level = MAX_int32;
+
+	for (int32 Iterator = 0; Iterator < FMath::Min(AllTags.Num(), 8); ++Iterator)
+	{
+		WorstItem.Tags.AddTag(AllTags.GetByIndex(Iterator));
+	}
+
+	LogItemWireSize(TEXT("Typical"), TypicalItem);
+	LogItemWireSize(TEXT("Empty"), FElementusItemInfo::EmptyItemInfo);
+	LogItemWireSize(TEXT("Worst case"), WorstItem);
+}
+
+static FAutoConsoleCommand ItemNetSizeBenchmarkCommand(TEXT("ElementusInventory.Benchmark.ItemNetSize"),
+                                                       TEXT("Log the bytes sent per replicated item with the default and the compact wire formats"),
+                                                       FConsoleCommandDelegate::CreateStatic(&RunItemNetSizeBenchmark));
+
+/* Timings of a single benchmarked operation at a given inventory size */
+struct FElementusBenchmarkResult
+{
+	FString Name;
+	int32 InventorySize = 0;
+	int32 ItemsPerCall = 1;
+
+	/* Duration of each call, in seconds */
+	TArray<double> Samples;
+
+	TSharedRef<FJsonObject> ToJson() const
+	{
+		TArray<double> SortedSamples = Samples;
+		SortedSamples.Sort();
+
+		double TotalSeconds = 0.0;
+		for (const double Iterator : SortedSamples)
+		{
+			TotalSeconds += Iterator;
+		}
+
+		const auto GetPercentileUs = [&SortedSamples](const double Percentile)
+		{
+			if (SortedSamples.IsEmpty())
+			{
+				return 0.0;
+			}
+
+			return SortedSamples[FMath::Min(FMath::FloorToInt(Percentile * SortedSamples.Num()), SortedSamples.Num() - 1)] * 1e6;
+		};
+
+		TSharedRef<FJsonObject> Output = MakeShared<FJsonObject>();
+		Output->SetStringField(TEXT("Name"), Name);
+		Output->SetNumberField(TEXT("InventorySize"), InventorySize);
+		Output->SetNumberField(TEXT("ItemsPerCall"), ItemsPerCall);
+		Output->SetNumberField(TEXT("Calls"), SortedSamples.Num());
+		Output->SetNumberField(TEXT("TotalMs"), TotalSeconds * 1e3);
+		Output->SetNumberField(TEXT("MeanUs"), SortedSamples.IsEmpty() ? 0.0 : TotalSeconds * 1e6 / SortedSamples.Num());
+		Output->SetNumberField(TEXT("MinUs"), GetPercentileUs(0.0));
+		Output->SetNumberField(TEXT("P50Us"), GetPercentileUs(0.5));
+		Output->SetNumberField(TEXT("P95Us"), GetPercentileUs(0.95));
+		Output->SetNumberField(TEXT("P99Us"), GetPercentileUs(0.99));
+		Output->SetNumberField(TEXT("MaxUs"), GetPercentileUs(1.0));
+		Output->SetNumberField(TEXT("ItemsPerSecond"), TotalSeconds > 0.0 ? ItemsPerCall * SortedSamples.Num() / TotalSeconds : 0.0);
+
+		return Output;
+	}
+};
+
+/* Measures the inventory operations on the inventories of a synthetic catalog */
+class FElementusOperationsBenchmark
+{
+public:
+	FElementusOperationsBenchmark(UWorld* InWorld, const int32 InNumIterations, const int32 InNumSamples)
+		: Catalog(InWorld), NumIterations(FMath::Max(InNumIterations, 1)), NumSamples(FMath::Max(InNumSamples, 1)), RandomStream(0x454C4D)
+	{
+	}
+
+	bool Initialize(const int32 CatalogSize)
+	{
+		return Catalog.Initialize(CatalogSize, RandomStream);
+	}
+
+	void Run(const int32 InventorySize)
+	{
+		const TArray<FElementusItemInfo> Items = MakeItems(InventorySize);
+		const FElementusItemInfo ExtraItem = MakeItem(InventorySize);
+
+		RunAdditionAndRemoval(InventorySize, Items, ExtraItem);
+		RunTrades(InventorySize, Items);
+		RunSorting(InventorySize, Items);
+		RunQueries(InventorySize, Items);
+		RunLookups(InventorySize);
+	}
+
+	const TArray<FElementusBenchmarkResult>& GetResults() const
+	{
+		return Results;
+	}
+
+	int32 GetNumTags() const
+	{
+		return Catalog.GetTags().Num();
+	}
+
+private:
+	template <typename FunctionTy>
+	static double MeasureCall(FunctionTy&& Function)
+	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Function();
+		return FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+	}
+
+	static FElementusBenchmarkResult MakeResult(const FString& Name, const int32 InventorySize, const int32 ItemsPerCall)
+	{
+		FElementusBenchmarkResult Output;
+		Output.Name = Name;
+		Output.InventorySize = InventorySize;
+		Output.ItemsPerCall = ItemsPerCall;
+
+		return Output;
+	}
+
+	/* Run the function NumSamples times, with the index of the current call */
+	template <typename FunctionTy>
+	void MeasureSamples(const TCHAR* Name, const int32 InventorySize, FunctionTy&& Function)
+	{
+		FElementusBenchmarkResult Result = MakeResult(Name, InventorySize, 1);
+		Result.Samples.Reserve(NumSamples);
+
+		for (int32 Iterator = 0; Iterator < NumSamples; ++Iterator)
+		{
+			Result.Samples.Add(MeasureCall([&Function, Iterator] { Function(Iterator); }));
+		}
+
+		Results.Add(MoveTemp(Result));
+	}
+
+	FElementusItemInfo MakeItem(const int32 CatalogIndex)
+	{
+		const UElementusItemData* const ItemData = Catalog.GetItemData(CatalogIndex);
+		const TArray<FGameplayTag>& Tags = Catalog.GetTags();
+
+		FElementusItemInfo Output(FPrimaryElementusItemId(ItemData->GetPrimaryAssetId()), ItemData->bIsStackable ? RandomStream.RandRange(1, 64) : 1);
+		Output.Level = RandomStream.RandRange(0, 10);
+
+		if (!Tags.IsEmpty() && CatalogIndex % 2 == 0)
+		{
+			Output.Tags.AddTag(Tags[CatalogIndex % Tags.Num()]);
+		}
+
+		return Output;
+	}
+
+	/* One distinct item per slot, in a random order */
+	TArray<FElementusItemInfo> MakeItems(const int32 InventorySize)
+	{
+		TArray<FElementusItemInfo> Output;
+		Output.Reserve(InventorySize);
+
+		for (int32 Iterator = 0; Iterator < InventorySize; ++Iterator)
+		{
+			Output.Add(MakeItem(Iterator));
+		}
+
+		for (int32 Iterator = Output.Num() - 1; Iterator > 0; --Iterator)
+		{
+			Output.Swap(Iterator, RandomStream.RandHelper(Iterator + 1));
+		}
+
+		return Output;
+	}
+
+	UElementusInventoryComponent* CreateInventory() const
+	{
+		return Catalog.CreateInventory();
+	}
+
+	static void DestroyInventory(UElementusInventoryComponent* Inventory)
+	{
+		FElementusInventoryTestCatalog::DestroyInventory(Inventory);
+	}
+
+	void RunAdditionAndRemoval(const int32 InventorySize, const TArray<FElementusItemInfo>& Items, const FElementusItemInfo& ExtraItem)
+	{
+		UElementusInventoryComponent* const Inventory = CreateInventory();
+
+		FElementusBenchmarkResult AddBatchResult = MakeResult(TEXT("Add.Batch"), InventorySize, Items.Num());
+		FElementusBenchmarkResult RemoveBatchResult = MakeResult(TEXT("Remove.Batch"), InventorySize, Items.Num());
+
+		for (int32 Iterator = 0; Iterator < NumIterations; ++Iterator)
+		{
+			AddBatchResult.Samples.Add(MeasureCall([&] { Inventory->AddItems(Items); }));
+			RemoveBatchResult.Samples.Add(MeasureCall([&] { Inventory->DiscardItems(Items); }));
+		}
+
+		// Latency of a single change in an inventory that already has InventorySize items
+		Inventory->AddItems(Items);
+
+		const TArray<FElementusItemInfo> ExtraItems { ExtraItem };
+		FElementusBenchmarkResult AddSingleResult = MakeResult(TEXT("Add.Single"), InventorySize, 1);
+		FElementusBenchmarkResult RemoveSingleResult = MakeResult(TEXT("Remove.Single"), InventorySize, 1);
+
+		for (int32 Iterator = 0; Iterator < NumSamples; ++Iterator)
+		{
+			AddSingleResult.Samples.Add(MeasureCall([&] { Inventory->AddItems(ExtraItems); }));
+			RemoveSingleResult.Samples.Add(MeasureCall([&] { Inventory->DiscardItems(ExtraItems); }));
+		}
+
+		DestroyInventory(Inventory);
+
+		Results.Add(MoveTemp(AddBatchResult));
+		Results.Add(MoveTemp(RemoveBatchResult));
+		Results.Add(MoveTemp(AddSingleResult));
+		Results.Add(MoveTemp(RemoveSingleResult));
+	}
+
+	void RunTrades(const int32 InventorySize, const TArray<FElementusItemInfo>& Items)
+	{
+		UElementusInventoryComponent* const FromInventory = CreateInventory();
+		UElementusInventoryComponent* const ToInventory = CreateInventory();
+
+		FromInventory->AddItems(Items);
+
+		TArray<EElementusTradeItemResult> TradeResults;
+
+		// Each sample moves the items to the other inventory and the next one moves them back
+		FElementusBenchmarkResult BatchResult = MakeResult(TEXT("Trade.Batch"), InventorySize, Items.Num());
+		for (int32 Iterator = 0; Iterator < NumIterations * 2; ++Iterator)
+		{
+			UElementusInventoryComponent* const Source = Iterator % 2 == 0 ? FromInventory : ToInventory;
+			UElementusInventoryComponent* const Target = Iterator % 2 == 0 ? ToInventory : FromInventory;
+
+			BatchResult.Samples.Add(MeasureCall([&] { UElementusInventoryFunctions::TradeItems(Source, Target, Items, TradeResults); }));
+		}
+
+		FElementusBenchmarkResult SingleResult = MakeResult(TEXT("Trade.Single"), InventorySize, 1);
+		for (int32 Iterator = 0; Iterator < NumSamples; ++Iterator)
+		{
+			const TArray<FElementusItemInfo> TradedItems { Items[Iterator % Items.Num()] };
+
+			SingleResult.Samples.Add(MeasureCall([&] { UElementusInventoryFunctions::TradeItems(FromInventory, ToInventory, TradedItems, TradeResults); }));
+			SingleResult.Samples.Add(MeasureCall([&] { UElementusInventoryFunctions::TradeItems(ToInventory, FromInventory, TradedItems, TradeResults); }));
+		}
+
+		DestroyInventory(FromInventory);
+		DestroyInventory(ToInventory);
+
+		Results.Add(MoveTemp(BatchResult));
+		Results.Add(MoveTemp(SingleResult));
+	}
+
+	void RunSorting(const int32 InventorySize, const TArray<FElementusItemInfo>& Items)
+	{
+		UElementusInventoryComponent* const Inventory = CreateInventory();
+		Inventory->AddItems(Items);
+
+		const UEnum* const SortingModeEnum = StaticEnum<EElementusInventorySortingMode>();
+
+		for (uint8 Mode = 0; Mode <= static_cast<uint8>(EElementusInventorySortingMode::Tags); ++Mode)
+		{
+			FElementusBenchmarkResult Result = MakeResult(TEXT("Sort.") + SortingModeEnum->GetNameStringByValue(Mode), InventorySize, Items.Num());
+
+			// Alternating the orientation reverses the items on each call, so no call receives already sorted items
+			for (int32 Iterator = 0; Iterator < NumIterations * 2; ++Iterator)
+			{
+				const EElementusInventorySortingOrientation Orientation = Iterator % 2 == 0
+					                                                          ? EElementusInventorySortingOrientation::Ascending
+					                                                          : EElementusInventorySortingOrientation::Descending;
+
+				Result.Samples.Add(MeasureCall([&] { Inventory->SortInventory(static_cast<EElementusInventorySortingMode>(Mode), Orientation); }));
+			}
+
+			Results.Add(MoveTemp(Result));
+		}
+
+		DestroyInventory(Inventory);
+	}
+
+	void RunQueries(const int32 InventorySize, const TArray<FElementusItemInfo>& Items)
+	{
+		UElementusInventoryComponent* const Inventory = CreateInventory();
+		Inventory->AddItems(Items);
+
+		TArray<int32> QueryIndexes;
+		QueryIndexes.Reserve(NumSamples);
+
+		for (int32 Iterator = 0; Iterator < NumSamples; ++Iterator)
+		{
+			QueryIndexes.Add(RandomStream.RandHelper(Items.Num()));
+		}
+
+		const auto GetQueryItem = [&Items, &QueryIndexes](const int32 Sample) -> const FElementusItemInfo&
+		{
+			return Items[QueryIndexes[Sample]];
+		};
+
+		const auto GetQueryTags = [&Tags = Catalog.GetTags()](const int32 Sample)
+		{
+			return Tags.IsEmpty() ? FGameplayTagContainer::EmptyContainer : FGameplayTagContainer(Tags[Sample % Tags.Num()]);
+		};
+
+		int32 Index;
+		TArray<int32> Indexes;
+
+		MeasureSamples(TEXT("Find.FirstIndexWithInfo"), InventorySize, [&](const int32 Sample)
+		{
+			Inventory->FindFirstItemIndexWithInfo(GetQueryItem(Sample), Index, FGameplayTagContainer::EmptyContainer);
+		});
+
+		MeasureSamples(TEXT("Find.FirstIndexWithId"), InventorySize, [&](const int32 Sample)
+		{
+			Inventory->FindFirstItemIndexWithId(GetQueryItem(Sample).ItemId, Index, FGameplayTagContainer::EmptyContainer);
+		});
+
+		MeasureSamples(TEXT("Find.FirstIndexWithTags"), InventorySize, [&](const int32 Sample)
+		{
+			Inventory->FindFirstItemIndexWithTags(GetQueryTags(Sample), Index, FGameplayTagContainer::EmptyContainer);
+		});
+
+		MeasureSamples(TEXT("Find.AllIndexesWithInfo"), InventorySize, [&](const int32 Sample)
+		{
+			Inventory->FindAllItemIndexesWithInfo(GetQueryItem(Sample), Indexes, FGameplayTagContainer::EmptyContainer);
+		});
+
+		MeasureSamples(TEXT("Find.AllIndexesWithId"), InventorySize, [&](const int32 Sample)
+		{
+			Inventory->FindAllItemIndexesWithId(GetQueryItem(Sample).ItemId, Indexes, FGameplayTagContainer::EmptyContainer);
+		});
+
+		MeasureSamples(TEXT("Find.AllIndexesWithTags"), InventorySize, [&](const int32 Sample)
+		{
+			Inventory->FindAllItemIndexesWithTags(GetQueryTags(Sample), Indexes, FGameplayTagContainer::EmptyContainer);
+		});
+
+		MeasureSamples(TEXT("Find.ContainsItem"), InventorySize, [&](const int32 Sample)
+		{
+			Inventory->ContainsItem(GetQueryItem(Sample));
+		});
+
+		MeasureSamples(TEXT("Find.ItemQuantity"), InventorySize, [&](const int32 Sample)
+		{
+			Inventory->GetItemQuantity(GetQueryItem(Sample));
+		});
+
+		MeasureSamples(TEXT("Find.ItemQuantityWithId"), InventorySize, [&](const int32 Sample)
+		{
+			Inventory->GetItemQuantityWithId(GetQueryItem(Sample).ItemId);
+		});
+
+		MeasureSamples(TEXT("Find.HasAllItems"), InventorySize, [&](const int32 Sample)
+		{
+			Inventory->HasAllItems({ GetQueryItem(Sample), GetQueryItem((Sample + 1) % NumSamples), GetQueryItem((Sample + 2) % NumSamples) });
+		});
+
+		DestroyInventory(Inventory);
+	}
+
+	/* Item data lookups of an inventory with InventorySize items: only the first InventorySize entries of the catalog are queried */
+	void RunLookups(const int32 InventorySize)
+	{
+		FElementusItemDefinitionCache& Cache = FElementusItemDefinitionCache::Get();
+
+		TArray<FPrimaryElementusItemId> QueryIds;
+		TArray<FElementusItemHandle> QueryHandles;
+		QueryIds.Reserve(NumSamples);
+		QueryHandles.Reserve(NumSamples);
+
+		for (int32 Iterator = 0; Iterator < NumSamples; ++Iterator)
+		{
+			QueryIds.Emplace(Catalog.GetItemData(RandomStream.RandHelper(InventorySize))->GetPrimaryAssetId());
+			QueryHandles.Add(Cache.InternItemId(QueryIds.Last()));
+		}
+
+		FElementusItemDefinition Definition;
+
+		MeasureSamples(TEXT("Lookup.DefinitionById"), InventorySize, [&](const int32 Sample)
+		{
+			Cache.FindDefinition(QueryIds[Sample], Definition);
+		});
+
+		MeasureSamples(TEXT("Lookup.DefinitionByHandle"), InventorySize, [&](const int32 Sample)
+		{
+			Cache.FindDefinition(QueryHandles[Sample], Definition);
+		});
+
+		MeasureSamples(TEXT("Lookup.CachedDefinitionById"), InventorySize, [&](const int32 Sample)
+		{
+			Cache.FindCachedDefinition(QueryIds[Sample], Definition);
+		});
+
+		MeasureSamples(TEXT("Lookup.ItemHandleById"), InventorySize, [&](const int32 Sample)
+		{
+			Cache.FindItemHandle(QueryIds[Sample]);
+		});
+
+		MeasureSamples(TEXT("Lookup.GetItemDefinitionById"), InventorySize, [&](const int32 Sample)
+		{
+			UElementusInventoryFunctions::GetItemDefinitionById(QueryIds[Sample], Definition);
+		});
+	}
+
+	FElementusInventoryTestCatalog Catalog;
+
+	const int32 NumIterations;
+	const int32 NumSamples;
+
+	FRandomStream RandomStream;
+	TArray<FElementusBenchmarkResult> Results;
+};
+
+static FString GetPluginVersionName()
+{
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("ElementusInventory"));
+	return Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : FString();
+}
+
+/* Run the benchmark for each inventory size and make the report with the results. Returns null if the benchmark can't run in the given world */
+static TSharedPtr<FJsonObject> MakeOperationsReport(UWorld* World, const TArray<int32>& Sizes, const int32 NumIterations, const int32 NumSamples)
+{
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+
+	// The benchmark objects must be released before the catalog definitions are removed from the cache
+	FElementusOperationsBenchmark Benchmark(World, NumIterations, NumSamples);
+
+	int32 MaxSize = 0;
+	for (const int32 Iterator : Sizes)
+	{
+		MaxSize = FMath::Max(MaxSize, Iterator);
+	}
+
+	// One more item than the largest inventory, to add and remove it from a full inventory
+	if (!Benchmark.Initialize(MaxSize + 1))
+	{
+		UE_LOG(LogElementusInventoryTests, Error, TEXT("%s: The benchmark requires a world with authority"), *FString(__FUNCTION__));
+		return nullptr;
+	}
+
+	for (const int32 Iterator : Sizes)
+	{
+		UE_LOG(LogElementusInventoryTests, Display, TEXT("%s: Running the operations benchmark with %d items"), *FString(__FUNCTION__), Iterator);
+		Benchmark.Run(Iterator);
+	}
+
+	TArray<TSharedPtr<FJsonValue>> ResultValues;
+	for (const FElementusBenchmarkResult& Iterator : Benchmark.GetResults())
+	{
+		ResultValues.Add(MakeShared<FJsonValueObject>(Iterator.ToJson()));
+	}
+
+	Report->SetStringField(TEXT("PluginVersion"), GetPluginVersionName());
+	Report->SetStringField(TEXT("EngineVersion"), FEngineVersion::Current().ToString());
+	Report->SetStringField(TEXT("BuildConfiguration"), LexToString(FApp::GetBuildConfiguration()));
+	Report->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+	Report->SetStringField(TEXT("Timestamp"), FDateTime::UtcNow().ToIso8601());
+	Report->SetNumberField(TEXT("Iterations"), NumIterations);
+	Report->SetNumberField(TEXT("Samples"), NumSamples);
+	Report->SetNumberField(TEXT("NumTags"), Benchmark.GetNumTags());
+	Report->SetArrayField(TEXT("Results"), ResultValues);
+
+	return Report;
+}
+
+static FString GetDefaultReportPath(const TCHAR* Name)
+{
+	return FPaths::ProjectSavedDir() / TEXT("ElementusInventory") / TEXT("Benchmarks") / FString::Printf(TEXT("%s_%s.json"), Name, *FDateTime::Now().ToString());
+}
+
+static bool WriteReport(const TSharedRef<FJsonObject>& Report, const FString& OutputPath)
+{
+	FString OutputString;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
+	FJsonSerializer::Serialize(Report, Writer);
+
+	if (!FFileHelper::SaveStringToFile(OutputString, *OutputPath))
+	{
+		UE_LOG(LogElementusInventoryTests, Error, TEXT("%s: Failed to write the benchmark results to '%s'"), *FString(__FUNCTION__), *OutputPath);
+		return false;
+	}
+
+	UE_LOG(LogElementusInventoryTests, Display, TEXT("%s: Wrote the benchmark results to '%s'"), *FString(__FUNCTION__), *OutputPath);
+	return true;
+}
+
+static void RunOperationsBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	if (!IsValid(World))
+	{
+		UE_LOG(LogElementusInventoryTests, Error, TEXT("%s: The benchmark requires a world"), *FString(__FUNCTION__));
+		return;
+	}
+
+	const FString JoinedArgs = FString::Join(Args, TEXT(" "));
+
+	FString SizesString = TEXT("10,100,1000,10000");
+	FParse::Value(*JoinedArgs, TEXT("Sizes="), SizesString);
+
+	TArray<FString> SizeStrings;
+	SizesString.ParseIntoArray(SizeStrings, TEXT(","));
+
+	TArray<int32> Sizes;
+	for (const FString& Iterator : SizeStrings)
+	{
+		if (const int32 Size = FCString::Atoi(*Iterator); Size > 0)
+		{
+			Sizes.Add(Size);
+		}
+	}
+
+	if (Sizes.IsEmpty())
+	{
+		UE_LOG(LogElementusInventoryTests, Error, TEXT("%s: No valid inventory size in '%s'"), *FString(__FUNCTION__), *SizesString);
+		return;
+	}
+
+	int32 NumIterations = 5;
+	FParse::Value(*JoinedArgs, TEXT("Iterations="), NumIterations);
+
+	int32 NumSamples = 256;
+	FParse::Value(*JoinedArgs, TEXT("Samples="), NumSamples);
+
+	FString OutputPath = GetDefaultReportPath(TEXT("Operations"));
+	FParse::Value(*JoinedArgs, TEXT("Output="), OutputPath);
+
+	if (const TSharedPtr<FJsonObject> Report = MakeOperationsReport(World, Sizes, NumIterations, NumSamples))
+	{
+		WriteReport(Report.ToSharedRef(), OutputPath);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs OperationsBenchmarkCommand(TEXT("ElementusInventory.Benchmark.Operations"),
+                                                                      TEXT("Measure the inventory operations with synthetic items and write the results as json. ")
+                                                                      TEXT("Args: Sizes=10,100,1000,10000 Iterations=5 Samples=256 Output=<Path>"),
+                                                                      FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunOperationsBenchmark));
+
+#if WITH_DEV_AUTOMATION_TESTS
+/**
+ * Headless run of the operations benchmark in a transient world, for the automation tests of the CI. The results are written to the saved
+ * benchmarks directory and the mean and p95 of each operation are added to the test report
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElementusInventoryOperationsBenchmarkTest, "ElementusInventory.Benchmarks.Operations",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+                                 EAutomationTestFlags::PerfFilter)
+
+bool FElementusInventoryOperationsBenchmarkTest::RunTest([[maybe_unused]] const FString& Parameters)
+{
+	const FElementusInventoryTestWorld World;
+
+	const TSharedPtr<FJsonObject> Report = MakeOperationsReport(World.Get(), { 10, 100, 1000 }, 5, 256);
+	if (!TestTrue(TEXT("Run the benchmark"), Report.IsValid()))
+	{
+		return false;
+	}
+
+	for (const TSharedPtr<FJsonValue>& Iterator : Report->GetArrayField(TEXT("Results")))
+	{
+		const TSharedPtr<FJsonObject>& Result = Iterator->AsObject();
+		AddInfo(FString::Printf(TEXT("%s (%d items): mean %.2f us, p95 %.2f us"), *Result->GetStringField(TEXT("Name")),
+		                        static_cast<int32>(Result->GetNumberField(TEXT("InventorySize"))), Result->GetNumberField(TEXT("MeanUs")),
+		                        Result->GetNumberField(TEXT("P95Us"))));
+	}
+
+	TestTrue(TEXT("Write the benchmark results"), WriteReport(Report.ToSharedRef(), GetDefaultReportPath(TEXT("Operations"))));
+
+	return true;
+}
+#endif
+#endif
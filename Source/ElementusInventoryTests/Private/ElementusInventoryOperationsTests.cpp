@@ -0,0 +1,251 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "ElementusInventoryTestCatalog.h"
+#include "Components/ElementusInventoryComponent.h"
+#include "Components/ElementusInventorySnapshot.h"
+#include <Misc/AutomationTest.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ElementusInventoryTests
+{
+	constexpr EAutomationTestFlags::Type OperationsTestFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+		EAutomationTestFlags::ServerContext | EAutomationTestFlags::ProductFilter;
+
+	/* Size of the catalog used by the operation tests: the check items are its first two entries */
+	constexpr int32 CatalogSize = 4;
+}
+
+/* Trades apply exactly what ValidateTrade accepted */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElementusInventoryTradeTest, "ElementusInventory.Operations.Trade", ElementusInventoryTests::OperationsTestFlags)
+
+bool FElementusInventoryTradeTest::RunTest([[maybe_unused]] const FString& Parameters)
+{
+	const FElementusInventoryTestWorld World;
+	FRandomStream RandomStream(0x454C4D);
+
+	FElementusInventoryTestCatalog Catalog(World.Get());
+	if (!TestTrue(TEXT("Initialize the catalog"), Catalog.Initialize(ElementusInventoryTests::CatalogSize, RandomStream)))
+	{
+		return false;
+	}
+
+	// Non-stackable items use one slot per unit: the whole quantity must leave the giver
+	{
+		const FElementusItemInfo Item = Catalog.MakeCheckItem(false, 3);
+
+		UElementusInventoryComponent* const FromInventory = Catalog.CreateInventory();
+		UElementusInventoryComponent* const ToInventory = Catalog.CreateInventory();
+		FromInventory->AddItems({ Item });
+
+		TArray<EElementusTradeItemResult> TradeResults;
+		UElementusInventoryFunctions::TradeItems(FromInventory, ToInventory, { Item }, TradeResults, true);
+
+		TestEqual(TEXT("Non-stackable quantity left in the giver"), FromInventory->GetItemQuantity(Item), 0);
+		TestEqual(TEXT("Non-stackable quantity received"), ToInventory->GetItemQuantity(Item), 3);
+		TestEqual(TEXT("Non-stackable slots left in the giver"), FromInventory->GetCurrentNumItems(), 0);
+		TestEqual(TEXT("Non-stackable slots received"), ToInventory->GetCurrentNumItems(), 3);
+
+		FElementusInventoryTestCatalog::DestroyInventory(FromInventory);
+		FElementusInventoryTestCatalog::DestroyInventory(ToInventory);
+	}
+
+	// A stackable item split across two stacks, which snapshots can restore: the quantity is taken from both
+	{
+		FElementusItemInfo Item = Catalog.MakeCheckItem(true, 5);
+
+		FElementusItemSlots SplitStacks;
+		SplitStacks.Add(Item, 2);
+
+		TArray<uint8> SnapshotData;
+		FElementusInventorySnapshot::Write(SnapshotData, SplitStacks, 0.f, 0.f, true);
+
+		UElementusInventoryComponent* const FromInventory = Catalog.CreateInventory();
+		UElementusInventoryComponent* const ToInventory = Catalog.CreateInventory();
+		FromInventory->LoadInventorySnapshot(SnapshotData);
+
+		Item.Quantity = 8;
+
+		TArray<EElementusTradeItemResult> TradeResults;
+		UElementusInventoryFunctions::TradeItems(FromInventory, ToInventory, { Item }, TradeResults, true);
+
+		TestEqual(TEXT("Split stack quantity left in the giver"), FromInventory->GetItemQuantity(Item), 2);
+		TestEqual(TEXT("Split stack quantity received"), ToInventory->GetItemQuantity(Item), 8);
+
+		FElementusInventoryTestCatalog::DestroyInventory(FromInventory);
+		FElementusInventoryTestCatalog::DestroyInventory(ToInventory);
+	}
+
+	return true;
+}
+
+/* Bulk operations apply exactly what their validation accepted, without exceeding the inventory slots */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElementusInventoryBulkTest, "ElementusInventory.Operations.Bulk", ElementusInventoryTests::OperationsTestFlags)
+
+bool FElementusInventoryBulkTest::RunTest([[maybe_unused]] const FString& Parameters)
+{
+	const FElementusInventoryTestWorld World;
+	FRandomStream RandomStream(0x454C4D);
+
+	FElementusInventoryTestCatalog Catalog(World.Get());
+	if (!TestTrue(TEXT("Initialize the catalog"), Catalog.Initialize(ElementusInventoryTests::CatalogSize, RandomStream)))
+	{
+		return false;
+	}
+
+	const FElementusItemInfo NonStackableItem = Catalog.MakeCheckItem(false, 3);
+	const FElementusItemInfo StackableItem = Catalog.MakeCheckItem(true, 2);
+
+	// Discarding non-stackable units must empty all of their slots, which are then available to the next operations
+	{
+		UElementusInventoryComponent* const Inventory = Catalog.CreateInventory(3);
+		Inventory->AddItems({ NonStackableItem });
+
+		const TArray<int32> NumAccepted = UElementusInventoryFunctions::ApplyBulkOperations({
+			FElementusInventoryTestCatalog::MakeBulkOperation(Inventory, EElementusBulkOperationType::DiscardItems, { NonStackableItem }),
+			FElementusInventoryTestCatalog::MakeBulkOperation(Inventory, EElementusBulkOperationType::AddItems, { StackableItem })
+		});
+
+		TestTrue(TEXT("Both operations accepted"), NumAccepted == TArray<int32> { 1, 1 });
+		TestEqual(TEXT("Discarded non-stackable quantity"), Inventory->GetItemQuantity(NonStackableItem), 0);
+		TestEqual(TEXT("Added stackable quantity"), Inventory->GetItemQuantity(StackableItem), 2);
+		TestEqual(TEXT("Slots after the discard and the addition"), Inventory->GetCurrentNumItems(), 1);
+
+		FElementusInventoryTestCatalog::DestroyInventory(Inventory);
+	}
+
+	// Identical new stackable entries of the same operation share a single slot
+	{
+		UElementusInventoryComponent* const Inventory = Catalog.CreateInventory(1);
+
+		const TArray<int32> NumAccepted = UElementusInventoryFunctions::ApplyBulkOperations({
+			FElementusInventoryTestCatalog::MakeBulkOperation(Inventory, EElementusBulkOperationType::AddItems, { StackableItem, StackableItem })
+		});
+
+		TestTrue(TEXT("Both stackable entries accepted"), NumAccepted == TArray<int32> { 2 });
+		TestEqual(TEXT("Stacked quantity"), Inventory->GetItemQuantity(StackableItem), 4);
+		TestEqual(TEXT("Stacked slots"), Inventory->GetCurrentNumItems(), 1);
+
+		FElementusInventoryTestCatalog::DestroyInventory(Inventory);
+	}
+
+	// Non-stackable units that don't fit in the available slots are rejected instead of exceeding them
+	{
+		UElementusInventoryComponent* const Inventory = Catalog.CreateInventory(2);
+
+		const TArray<int32> NumAccepted = UElementusInventoryFunctions::ApplyBulkOperations({
+			FElementusInventoryTestCatalog::MakeBulkOperation(Inventory, EElementusBulkOperationType::AddItems, { NonStackableItem })
+		});
+
+		TestTrue(TEXT("Units past the max num of items rejected"), NumAccepted == TArray<int32> { 0 });
+		TestEqual(TEXT("Slots after the rejected addition"), Inventory->GetCurrentNumItems(), 0);
+
+		FElementusInventoryTestCatalog::DestroyInventory(Inventory);
+	}
+
+	return true;
+}
+
+/* Rolling back a transaction restores the slots written, moved and removed since it began */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElementusInventoryTransactionTest, "ElementusInventory.Operations.Transaction", ElementusInventoryTests::OperationsTestFlags)
+
+bool FElementusInventoryTransactionTest::RunTest([[maybe_unused]] const FString& Parameters)
+{
+	const FElementusInventoryTestWorld World;
+	FRandomStream RandomStream(0x454C4D);
+
+	FElementusInventoryTestCatalog Catalog(World.Get());
+	if (!TestTrue(TEXT("Initialize the catalog"), Catalog.Initialize(ElementusInventoryTests::CatalogSize, RandomStream)))
+	{
+		return false;
+	}
+
+	const FElementusItemInfo NonStackableItem = Catalog.MakeCheckItem(false, 1);
+	const FElementusItemInfo StackableItem = Catalog.MakeCheckItem(true, 2);
+
+	UElementusInventoryComponent* const Inventory = Catalog.CreateInventory();
+	Inventory->AddItems({ NonStackableItem, StackableItem, NonStackableItem });
+
+	const TArray<FElementusItemInfo> InitialItems = Inventory->GetItemsArray();
+	const float InitialWeight = Inventory->GetCurrentWeight();
+
+	// Changed, shifted and added slots
+	Inventory->BeginInventoryTransaction();
+	Inventory->AddItems({ StackableItem, NonStackableItem });
+	Inventory->DiscardItemIndexes({ 0 });
+	Inventory->RollbackInventoryTransaction();
+
+	TestTrue(TEXT("Slots restored after changes"), FElementusInventoryTestCatalog::HasSameSlots(Inventory->GetItemsArray(), InitialItems));
+	TestEqual(TEXT("Weight restored after changes"), Inventory->GetCurrentWeight(), InitialWeight);
+
+	// Cleared slots are restored without having been sent to the clients
+	Inventory->BeginInventoryTransaction();
+	Inventory->ClearInventory();
+	Inventory->AddItems({ StackableItem });
+	Inventory->RollbackInventoryTransaction();
+
+	TestTrue(TEXT("Slots restored after a clear"), FElementusInventoryTestCatalog::HasSameSlots(Inventory->GetItemsArray(), InitialItems));
+	TestEqual(TEXT("Weight restored after a clear"), Inventory->GetCurrentWeight(), InitialWeight);
+
+	FElementusInventoryTestCatalog::DestroyInventory(Inventory);
+
+	return true;
+}
+
+/* Identical neighbor slots share a single run without changing the slots seen by the callers */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElementusInventorySlotRunsTest, "ElementusInventory.Operations.SlotRuns", ElementusInventoryTests::OperationsTestFlags)
+
+bool FElementusInventorySlotRunsTest::RunTest([[maybe_unused]] const FString& Parameters)
+{
+	const FElementusInventoryTestWorld World;
+	FRandomStream RandomStream(0x454C4D);
+
+	FElementusInventoryTestCatalog Catalog(World.Get());
+	if (!TestTrue(TEXT("Initialize the catalog"), Catalog.Initialize(ElementusInventoryTests::CatalogSize, RandomStream)))
+	{
+		return false;
+	}
+
+	const FElementusItemInfo NonStackableItem = Catalog.MakeCheckItem(false, 1000);
+	const FElementusItemInfo StackableItem = Catalog.MakeCheckItem(true, 1);
+
+	UElementusInventoryComponent* const CompactInventory = Catalog.CreateInventory();
+	CompactInventory->bCompactItemRuns = true;
+	CompactInventory->AddItems({ NonStackableItem, StackableItem });
+
+	UElementusInventoryComponent* const ExpandedInventory = Catalog.CreateInventory();
+	ExpandedInventory->bCompactItemRuns = false;
+	ExpandedInventory->AddItems({ NonStackableItem, StackableItem });
+
+	const FElementusItemSlots& CompactSlots = CompactInventory->GetItemsView();
+	const FElementusItemSlots& ExpandedSlots = ExpandedInventory->GetItemsView();
+
+	TestEqual(TEXT("Compact slots"), CompactSlots.Num(), 1001);
+	TestEqual(TEXT("Compact runs"), CompactSlots.GetRuns().Num(), 2);
+	TestEqual(TEXT("Expanded runs"), ExpandedSlots.GetRuns().Num(), 1001);
+
+	// Removing a unit only shortens its run
+	FElementusItemInfo SingleUnit = NonStackableItem;
+	SingleUnit.Quantity = 1;
+
+	CompactInventory->DiscardItems({ SingleUnit });
+	ExpandedInventory->DiscardItems({ SingleUnit });
+
+	TestEqual(TEXT("Compact slots after removing a unit"), CompactSlots.Num(), 1000);
+	TestEqual(TEXT("Compact runs after removing a unit"), CompactSlots.GetRuns().Num(), 2);
+	TestEqual(TEXT("Quantity after removing a unit"), CompactInventory->GetItemQuantity(SingleUnit), 999);
+	TestTrue(TEXT("Slot after the shortened run"), CompactSlots[999] == StackableItem);
+
+	TestTrue(TEXT("Same slots as the expanded inventory"), FElementusInventoryTestCatalog::HasSameSlots(CompactInventory->GetItemsArray(),
+		         ExpandedInventory->GetItemsArray()));
+	TestEqual(TEXT("Same weight as the expanded inventory"), CompactInventory->GetCurrentWeight(), ExpandedInventory->GetCurrentWeight());
+
+	FElementusInventoryTestCatalog::DestroyInventory(CompactInventory);
+	FElementusInventoryTestCatalog::DestroyInventory(ExpandedInventory);
+
+	return true;
+}
+
+#endif
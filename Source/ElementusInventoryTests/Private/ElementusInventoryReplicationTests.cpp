@@ -0,0 +1,199 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "ElementusInventoryTestCatalog.h"
+#include "Components/ElementusInventoryComponent.h"
+#include "Components/ElementusInventoryReplication.h"
+#include "LogElementusInventoryTests.h"
+#include <Engine/DemoNetDriver.h>
+#include <Net/RepLayout.h>
+#include <UObject/CoreNet.h>
+#include <UObject/StrongObjectPtr.h>
+#include <Misc/AutomationTest.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Bits sent for each inventory change by the fast array delta serialization of the replicated items, the same path the net driver uses for
+ * the component. Each delta is written from the state of the previous one, as if the client had acknowledged it
+ */
+class FElementusReplicationBandwidth
+{
+public:
+	explicit FElementusReplicationBandwidth(UElementusInventoryComponent* InInventory) : Inventory(InInventory)
+	{
+		// The item structs are written with the rep layout of the driver. A demo driver doesn't need a connection to create them
+		NetDriver.Reset(NewObject<UDemoNetDriver>(GetTransientPackage()));
+
+		const FStructProperty* const Property = FindFProperty<FStructProperty>(UElementusInventoryComponent::StaticClass(), TEXT("ReplicatedItems"));
+		ReplicatedItems = Property ? Property->ContainerPtrToValuePtr<FElementusReplicatedItemArray>(Inventory) : nullptr;
+	}
+
+	bool IsValid() const
+	{
+		return ReplicatedItems != nullptr;
+	}
+
+	/* Bits of the whole current state, sent to a connection that has nothing yet. The next deltas are written from this state */
+	int64 SerializeFullState()
+	{
+		AcknowledgedState.Reset();
+		return SerializeDelta();
+	}
+
+	/* Bits of the changes since the acknowledged state, 0 if nothing is sent */
+	int64 SerializeDelta()
+	{
+		FNetBitWriter Writer(nullptr, 0);
+		FNetSerializeCB NetSerializeCB(NetDriver.Get());
+
+		TSharedPtr<INetDeltaBaseState> NewState;
+
+		FNetDeltaSerializeInfo Parms;
+		Parms.Writer = &Writer;
+		Parms.NetSerializeCB = &NetSerializeCB;
+		Parms.OldState = AcknowledgedState.Get();
+		Parms.NewState = &NewState;
+		Parms.Object = Inventory;
+
+		if (!ReplicatedItems->NetDeltaSerialize(Parms))
+		{
+			return 0;
+		}
+
+		AcknowledgedState = NewState;
+		return Writer.GetNumBits();
+	}
+
+private:
+	UElementusInventoryComponent* Inventory;
+	FElementusReplicatedItemArray* ReplicatedItems = nullptr;
+
+	TStrongObjectPtr<UDemoNetDriver> NetDriver;
+	TSharedPtr<INetDeltaBaseState> AcknowledgedState;
+};
+
+static bool IsSameSlot(const FElementusItemInfo& A, const FElementusItemInfo& B)
+{
+	return A.ItemId == B.ItemId && A.Level == B.Level && A.Quantity == B.Quantity && A.Tags == B.Tags;
+}
+
+static int64 GetItemNetBits(FElementusItemInfo InItemInfo)
+{
+	FNetBitWriter Writer(nullptr, 0);
+
+	bool bSuccess = true;
+	InItemInfo.NetSerialize(Writer, nullptr, bSuccess);
+
+	return Writer.GetNumBits();
+}
+
+/**
+ * Lower bound of the bits the former plain array property sent for the same change: the rep layout of an array sends every slot that differs
+ * at its index, so a change shifting the slots resends all the following ones. Only the item data is counted, without the array size and the
+ * property handles
+ */
+static int64 GetPlainArrayBits(const TArray<FElementusItemInfo>& Before, const TArray<FElementusItemInfo>& After)
+{
+	int64 Output = 0;
+	for (int32 Iterator = 0; Iterator < After.Num(); ++Iterator)
+	{
+		if (!Before.IsValidIndex(Iterator) || !IsSameSlot(Before[Iterator], After[Iterator]))
+		{
+			Output += GetItemNetBits(After[Iterator]);
+		}
+	}
+
+	return Output;
+}
+
+/* Bytes sent per inventory change through the fast array, compared with the full state and with the former plain array */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FElementusInventoryReplicationBenchmarkTest, "ElementusInventory.Benchmarks.Replication",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext |
+                                 EAutomationTestFlags::PerfFilter)
+
+bool FElementusInventoryReplicationBenchmarkTest::RunTest([[maybe_unused]] const FString& Parameters)
+{
+	const FElementusInventoryTestWorld World;
+	FRandomStream RandomStream(0x454C4D);
+
+	const TArray<int32> Sizes { 10, 100, 1000 };
+
+	// One more item than the largest inventory, to add and remove it from a full inventory
+	FElementusInventoryTestCatalog Catalog(World.Get());
+	if (!TestTrue(TEXT("Initialize the catalog"), Catalog.Initialize(Sizes.Last() + 1, RandomStream)))
+	{
+		return false;
+	}
+
+	const auto MakeItem = [&Catalog](const int32 CatalogIndex, const int32 Quantity)
+	{
+		return FElementusItemInfo(FPrimaryElementusItemId(Catalog.GetItemData(CatalogIndex)->GetPrimaryAssetId()), Quantity);
+	};
+
+	for (const int32 Size : Sizes)
+	{
+		// One distinct item per slot. Every fourth item isn't stackable, so the second one is
+		TArray<FElementusItemInfo> Items;
+		for (int32 Iterator = 0; Iterator < Size; ++Iterator)
+		{
+			Items.Add(MakeItem(Iterator, Catalog.GetItemData(Iterator)->bIsStackable ? RandomStream.RandRange(1, 64) : 1));
+		}
+
+		UElementusInventoryComponent* const Inventory = Catalog.CreateInventory();
+		Inventory->AddItems(Items);
+
+		FElementusReplicationBandwidth Bandwidth(Inventory);
+		if (!TestTrue(TEXT("Find the replicated items"), Bandwidth.IsValid()))
+		{
+			FElementusInventoryTestCatalog::DestroyInventory(Inventory);
+			return false;
+		}
+
+		const int64 FullStateBits = Bandwidth.SerializeFullState();
+
+		const auto MeasureChange = [&](const TCHAR* Name, const TFunctionRef<void()> Change)
+		{
+			const TArray<FElementusItemInfo> Before = Inventory->GetItemsArray();
+			Change();
+			const TArray<FElementusItemInfo> After = Inventory->GetItemsArray();
+
+			const int64 DeltaBits = Bandwidth.SerializeDelta();
+			const int64 PlainArrayBits = GetPlainArrayBits(Before, After);
+
+			AddInfo(FString::Printf(TEXT("%s (%d items): %lld bytes, plain array at least %lld bytes, full state %lld bytes"), Name, Size,
+			                        FMath::DivideAndRoundUp<int64>(DeltaBits, 8), FMath::DivideAndRoundUp<int64>(PlainArrayBits, 8),
+			                        FMath::DivideAndRoundUp<int64>(FullStateBits, 8)));
+
+			UE_LOG(LogElementusInventoryTests, Display, TEXT("%s: %s (%d items): %lld bits, plain array %lld bits, full state %lld bits"),
+			       *FString(__FUNCTION__), Name, Size, DeltaBits, PlainArrayBits, FullStateBits);
+
+			return DeltaBits;
+		};
+
+		const int64 QuantityBits = MeasureChange(TEXT("Quantity.Change"), [&] { Inventory->AddItems({ MakeItem(1, 1) }); });
+		const int64 AddBits = MeasureChange(TEXT("Add.Single"), [&] { Inventory->AddItems({ MakeItem(Size, 1) }); });
+		const int64 RemoveBits = MeasureChange(TEXT("Remove.Single"), [&] { Inventory->DiscardItems({ MakeItem(Size, 1) }); });
+		MeasureChange(TEXT("Remove.First"), [&] { Inventory->DiscardItems({ Inventory->GetItemCopyAt(0) }); });
+		MeasureChange(TEXT("Sort.Reverse"), [&]
+		{
+			Inventory->SortInventory(EElementusInventorySortingMode::ID, EElementusInventorySortingOrientation::Descending);
+		});
+
+		TestEqual(TEXT("Nothing is sent without changes"), MeasureChange(TEXT("Unchanged"), [] {}), 0ll);
+
+		// A single slot change must cost less than resending the inventory, once it holds more than a few items
+		if (Size >= 100)
+		{
+			TestTrue(FString::Printf(TEXT("Quantity change smaller than the full state with %d items"), Size), QuantityBits < FullStateBits);
+			TestTrue(FString::Printf(TEXT("Single addition smaller than the full state with %d items"), Size), AddBits < FullStateBits);
+			TestTrue(FString::Printf(TEXT("Single removal smaller than the full state with %d items"), Size), RemoveBits < FullStateBits);
+		}
+
+		FElementusInventoryTestCatalog::DestroyInventory(Inventory);
+	}
+
+	return true;
+}
+#endif
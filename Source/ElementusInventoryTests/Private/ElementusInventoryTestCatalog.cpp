@@ -0,0 +1,154 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "ElementusInventoryTestCatalog.h"
+#include "Management/ElementusInventoryCache.h"
+#include "Components/ElementusInventoryComponent.h"
+#include <GameplayTagsManager.h>
+#include <GameFramework/Actor.h>
+#include <Engine/Engine.h>
+#include <Engine/World.h>
+
+FElementusInventoryTestWorld::FElementusInventoryTestWorld()
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ElementusInventoryTestWorld"));
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+}
+
+FElementusInventoryTestWorld::~FElementusInventoryTestWorld()
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+}
+
+FElementusInventoryTestCatalog::FElementusInventoryTestCatalog(UWorld* InWorld) : World(InWorld)
+{
+}
+
+FElementusInventoryTestCatalog::~FElementusInventoryTestCatalog()
+{
+	if (IsValid(Owner))
+	{
+		Owner->Destroy();
+	}
+
+	for (const TStrongObjectPtr<UElementusItemData>& Iterator : Catalog)
+	{
+		FElementusItemDefinitionCache::Get().Invalidate(Iterator->GetPrimaryAssetId());
+	}
+}
+
+bool FElementusInventoryTestCatalog::Initialize(const int32 CatalogSize, FRandomStream& RandomStream)
+{
+	if (!IsValid(World))
+	{
+		return false;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+
+	Owner = World->SpawnActor<AActor>(AActor::StaticClass(), SpawnParameters);
+	if (!IsValid(Owner) || Owner->GetLocalRole() != ROLE_Authority)
+	{
+		return false;
+	}
+
+	FGameplayTagContainer AllTags;
+	UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, true);
+
+	for (int32 Iterator = 0; Iterator < FMath::Min(AllTags.Num(), 8); ++Iterator)
+	{
+		Tags.Add(AllTags.GetByIndex(Iterator));
+	}
+
+	constexpr uint8 NumItemTypes = static_cast<uint8>(EElementusItemType::MAX);
+
+	Catalog.Reserve(CatalogSize);
+	for (int32 Iterator = 0; Iterator < CatalogSize; ++Iterator)
+	{
+		UElementusItemData* const ItemData = NewObject<UElementusItemData>(GetTransientPackage(), NAME_None, RF_Transient);
+		ItemData->ItemId = FirstItemId + Iterator;
+		ItemData->ItemName = *FString::Printf(TEXT("TestItem_%d"), RandomStream.RandHelper(CatalogSize));
+		ItemData->ItemType = static_cast<EElementusItemType>(Iterator % NumItemTypes);
+		ItemData->bIsStackable = Iterator % 4 != 0;
+		ItemData->ItemValue = RandomStream.FRandRange(0.f, 1000.f);
+		ItemData->ItemWeight = RandomStream.FRandRange(0.f, 10.f);
+
+		FElementusItemDefinitionCache::Get().RegisterItemData(ItemData);
+		Catalog.Emplace(ItemData);
+	}
+
+	return true;
+}
+
+FElementusItemInfo FElementusInventoryTestCatalog::MakeCheckItem(const bool bIsStackable, const int32 Quantity) const
+{
+	const int32 CatalogIndex = bIsStackable ? 1 : 0;
+	check(Catalog.IsValidIndex(CatalogIndex) && Catalog[CatalogIndex]->bIsStackable == bIsStackable);
+
+	return FElementusItemInfo(FPrimaryElementusItemId(Catalog[CatalogIndex]->GetPrimaryAssetId()), Quantity);
+}
+
+UElementusInventoryComponent* FElementusInventoryTestCatalog::CreateInventory(const int32 MaxNumItems) const
+{
+	UElementusInventoryComponent* const Inventory = NewObject<UElementusInventoryComponent>(Owner, NAME_None, RF_Transient);
+
+	// The capacity limits are private and copied from the settings: lift them so the inventory can hold the whole catalog
+	if (FFloatProperty* const MaxWeightProperty = FindFProperty<FFloatProperty>(UElementusInventoryComponent::StaticClass(), TEXT("MaxWeight")))
+	{
+		MaxWeightProperty->SetPropertyValue_InContainer(Inventory, 0.f);
+	}
+
+	if (FIntProperty* const MaxNumItemsProperty = FindFProperty<FIntProperty>(UElementusInventoryComponent::StaticClass(), TEXT("MaxNumItems")))
+	{
+		MaxNumItemsProperty->SetPropertyValue_InContainer(Inventory, MaxNumItems);
+	}
+
+	Inventory->RegisterComponent();
+	return Inventory;
+}
+
+void FElementusInventoryTestCatalog::DestroyInventory(UElementusInventoryComponent* Inventory)
+{
+	if (IsValid(Inventory))
+	{
+		Inventory->DestroyComponent();
+	}
+}
+
+bool FElementusInventoryTestCatalog::HasSameSlots(const TArray<FElementusItemInfo>& A, const TArray<FElementusItemInfo>& B)
+{
+	if (A.Num() != B.Num())
+	{
+		return false;
+	}
+
+	for (int32 Iterator = 0; Iterator < A.Num(); ++Iterator)
+	{
+		if (A[Iterator] != B[Iterator] || A[Iterator].Quantity != B[Iterator].Quantity)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+FElementusBulkInventoryOperation FElementusInventoryTestCatalog::MakeBulkOperation(UElementusInventoryComponent* Inventory,
+                                                                                   const EElementusBulkOperationType Type,
+                                                                                   const TArray<FElementusItemInfo>& Items)
+{
+	FElementusBulkInventoryOperation Output;
+	Output.Inventory = Inventory;
+	Output.Operation = Type;
+	Output.Items = Items;
+
+	return Output;
+}
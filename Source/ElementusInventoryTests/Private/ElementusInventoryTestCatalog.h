@@ -0,0 +1,83 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <UObject/StrongObjectPtr.h>
+#include "Management/ElementusInventoryData.h"
+#include "Management/ElementusInventoryFunctions.h"
+
+class AActor;
+class UWorld;
+class UElementusInventoryComponent;
+
+/* Transient game world that has begun play, so the components registered in it run their BeginPlay with authority */
+class FElementusInventoryTestWorld
+{
+public:
+	FElementusInventoryTestWorld();
+	~FElementusInventoryTestWorld();
+
+	UWorld* Get() const
+	{
+		return World;
+	}
+
+private:
+	UWorld* World = nullptr;
+};
+
+/**
+ * Synthetic catalog and inventories used by the tests and the benchmarks. Items are transient item datas registered in the definition cache,
+ * with ids far from the project items, so they don't depend on the project content or on the Asset Manager
+ */
+class FElementusInventoryTestCatalog
+{
+public:
+	static constexpr int32 FirstItemId = 1000000;
+
+	explicit FElementusInventoryTestCatalog(UWorld* InWorld);
+	~FElementusInventoryTestCatalog();
+
+	/* Spawn the owner of the inventories and register the given num of items. Every fourth item isn't stackable, starting from the first one */
+	bool Initialize(const int32 CatalogSize, FRandomStream& RandomStream);
+
+	int32 Num() const
+	{
+		return Catalog.Num();
+	}
+
+	const UElementusItemData* GetItemData(const int32 CatalogIndex) const
+	{
+		return Catalog[CatalogIndex].Get();
+	}
+
+	/* Up to 8 tags of the project, used to tag the items */
+	const TArray<FGameplayTag>& GetTags() const
+	{
+		return Tags;
+	}
+
+	/* Item of the catalog with the given stackability, without tags and with the default level */
+	FElementusItemInfo MakeCheckItem(const bool bIsStackable, const int32 Quantity) const;
+
+	/* Create an inventory without weight limit and with the given max num of items, 0 for no limit */
+	UElementusInventoryComponent* CreateInventory(const int32 MaxNumItems = 0) const;
+
+	static void DestroyInventory(UElementusInventoryComponent* Inventory);
+
+	/* Compare the slots including their quantities, which the item info comparison ignores */
+	static bool HasSameSlots(const TArray<FElementusItemInfo>& A, const TArray<FElementusItemInfo>& B);
+
+	static FElementusBulkInventoryOperation MakeBulkOperation(UElementusInventoryComponent* Inventory, const EElementusBulkOperationType Type,
+	                                                          const TArray<FElementusItemInfo>& Items);
+
+private:
+	UWorld* World;
+	AActor* Owner = nullptr;
+
+	TArray<TStrongObjectPtr<UElementusItemData>> Catalog;
+	TArray<FGameplayTag> Tags;
+};
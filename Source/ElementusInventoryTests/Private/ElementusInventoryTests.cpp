@@ -0,0 +1,11 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#include "ElementusInventoryTests.h"
+#include "LogElementusInventoryTests.h"
+#include <Modules/ModuleManager.h>
+
+DEFINE_LOG_CATEGORY(LogElementusInventoryTests);
+
+IMPLEMENT_MODULE(FElementusInventoryTestsModule, ElementusInventoryTests)
@@ -0,0 +1,10 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Logging/LogMacros.h>
+
+DECLARE_LOG_CATEGORY_EXTERN(LogElementusInventoryTests, Display, All);
@@ -0,0 +1,12 @@
+// Author: Lucas Vilas-Boas
+// Year: 2023
+// Repo: https://github.com/lucoiso/UEElementusInventory
+
+#pragma once
+
+#include <Modules/ModuleInterface.h>
+
+/* Automation tests and benchmarks of the inventory operations. Not part of the runtime module, so shipping builds don't include them */
+class FElementusInventoryTestsModule : public IModuleInterface
+{
+};